@@ -20,21 +20,15 @@ namespace CepGen
 
         //--- type of process to consider
         const std::string proc_name = proc["name"];
-        if ( proc_name == "lpair" ) params_.setProcess( new Process::GamGamLL );
+        if ( proc_name == "lpair" ) {
+          int nopt = 0; // optimisation of the phase space mappings (see GamGamLL)
+          proc.lookupValue( "nopt", nopt );
+          params_.setProcess( new Process::GamGamLL( nopt ) );
+        }
         else FatalError( Form( "Unrecognised process: %s", proc_name.c_str() ) );
 
         //--- process mode
-        int int_mode; std::string str_mode;
-        if ( proc.lookupValue( "mode", int_mode ) ) {
-          params_.kinematics.mode = (Kinematics::ProcessMode)int_mode;
-        }
-        else if ( proc.lookupValue( "mode", str_mode ) ) {
-          if ( str_mode == "elastic/elastic" ) params_.kinematics.mode = Kinematics::ProcessMode::ElasticElastic;
-          else if ( str_mode == "elastic/inelastic" ) params_.kinematics.mode = Kinematics::ProcessMode::ElasticInelastic;
-          else if ( str_mode == "inelastic/elastic" ) params_.kinematics.mode = Kinematics::ProcessMode::InelasticElastic;
-          else if ( str_mode == "inelastic/inelastic" ) params_.kinematics.mode = Kinematics::ProcessMode::InelasticInelastic;
-          else FatalError( Form( "Unrecognised interaction mode: %s", str_mode.c_str() ) );
-        }
+        if ( proc.exists( "mode" ) ) params_.kinematics.mode = parseMode( proc["mode"] );
 
         //--- process kinematics
         if ( proc.exists( "in_kinematics" ) ) parseIncomingKinematics( proc["in_kinematics"] );
@@ -47,6 +41,22 @@ namespace CepGen
         //--- taming functions
         if ( proc.exists( "taming_functions" ) ) parseTamingFunctions( proc["taming_functions"] );
 
+        //--- cocktail of processes modes
+        if ( proc.exists( "cocktail" ) ) parseCocktail( proc["cocktail"] );
+
+        //--- cross section scan
+        if ( root.exists( "scan" ) ) parseScan( root["scan"] );
+
+        //--- differential cross sections
+        if ( root.exists( "histograms" ) ) parseHistograms( root["histograms"] );
+
+        //--- run report
+        if ( root.exists( "report_file" ) ) params_.report_file = (const char*)root["report_file"];
+
+        //--- timeline trace
+        if ( root.exists( "trace_file" ) ) params_.trace_file = (const char*)root["trace_file"];
+        if ( root.exists( "trace_capacity" ) ) params_.trace_capacity = (int)root["trace_capacity"];
+
       } catch ( const libconfig::SettingNotFoundException& nfe ) {
         FatalError( Form( "Failed to retrieve the field \"%s\".", nfe.getPath() ) );
       } catch ( const libconfig::SettingTypeException& te ) {
@@ -60,18 +70,7 @@ namespace CepGen
       try {
         if ( kin.exists( "beam1_pz" ) ) params_.kinematics.in1p = (double)kin["beam1_pz"];
         if ( kin.exists( "beam2_pz" ) ) params_.kinematics.in2p = (double)kin["beam2_pz"];
-        if ( kin.exists( "structure_functions" ) ) {
-          std::string sf = kin["structure_functions" ];
-          if ( sf == "electron" ) params_.remnant_mode = Electron;
-          else if ( sf == "elastic proton" ) params_.remnant_mode = ElasticProton;
-          else if ( sf == "Suri-Yennie" ) params_.remnant_mode = SuriYennie;
-          else if ( sf == "Suri-Yennie;lowQ2" ) params_.remnant_mode = SuriYennieLowQ2;
-          else if ( sf == "Szczurek-Uleshchenko" ) params_.remnant_mode = SzczurekUleshchenko;
-          else if ( sf == "Fiore;valence" ) params_.remnant_mode = FioreVal;
-          else if ( sf == "Fiore;sea" ) params_.remnant_mode = FioreSea;
-          else if ( sf == "Fiore" ) params_.remnant_mode = Fiore;
-          else FatalError( Form( "Invalid structure functions mode: %s", sf.c_str() ) );
-        }
+        if ( kin.exists( "structure_functions" ) ) params_.remnant_mode = parseStructureFunctions( kin["structure_functions"] );
       } catch ( const libconfig::SettingNotFoundException& nfe ) {
         FatalError( Form( "Failed to retrieve the field \"%s\".", nfe.getPath() ) );
       } catch ( const libconfig::SettingTypeException& te ) {
@@ -100,6 +99,70 @@ namespace CepGen
       }
     }
 
+    void
+    ConfigReader::parseCocktail( const libconfig::Setting& cocktail )
+    {
+      try {
+        for ( unsigned short i=0; i<cocktail.getLength(); i++ ) {
+          const libconfig::Setting& chan = cocktail[i];
+          Parameters::CocktailChannel channel( params_.kinematics.mode, params_.remnant_mode, params_.kinematics.pair );
+          if ( chan.exists( "mode" ) ) channel.mode = parseMode( chan["mode"] );
+          if ( chan.exists( "structure_functions" ) ) channel.remnant_mode = parseStructureFunctions( chan["structure_functions"] );
+          if ( chan.exists( "pair" ) ) channel.pair = (Particle::ParticleCode)(int)chan["pair"];
+          params_.cocktail.emplace_back( channel );
+        }
+      } catch ( const libconfig::SettingNotFoundException& nfe ) {
+        FatalError( Form( "Failed to retrieve the field \"%s\".", nfe.getPath() ) );
+      } catch ( const libconfig::SettingTypeException& te ) {
+        FatalError( Form( "Field \"%s\" has wrong type.", te.getPath() ) );
+      }
+    }
+
+    void
+    ConfigReader::parseScan( const libconfig::Setting& scan )
+    {
+      try {
+        params_.scan.parameter = (const char*)scan["parameter"];
+        if ( scan.exists( "values" ) ) {
+          const libconfig::Setting& values = scan["values"];
+          for ( unsigned short i=0; i<values.getLength(); i++ ) params_.scan.values.emplace_back( (double)values[i] );
+        }
+        else params_.scan.setRange( (double)scan["min"], (double)scan["max"], (int)scan["num_points"] );
+        if ( scan.exists( "num_threads" ) ) params_.scan.num_threads = (int)scan["num_threads"];
+        if ( scan.exists( "warm_start" ) ) params_.scan.warm_start = (bool)scan["warm_start"];
+      } catch ( const libconfig::SettingNotFoundException& nfe ) {
+        FatalError( Form( "Failed to retrieve the field \"%s\".", nfe.getPath() ) );
+      } catch ( const libconfig::SettingTypeException& te ) {
+        FatalError( Form( "Field \"%s\" has wrong type.", te.getPath() ) );
+      }
+    }
+
+    Kinematics::ProcessMode
+    ConfigReader::parseMode( const libconfig::Setting& mode )
+    {
+      if ( mode.getType() == libconfig::Setting::TypeInt ) return (Kinematics::ProcessMode)(int)mode;
+      const std::string str_mode = mode;
+      if ( str_mode == "elastic/elastic" ) return Kinematics::ProcessMode::ElasticElastic;
+      if ( str_mode == "elastic/inelastic" ) return Kinematics::ProcessMode::ElasticInelastic;
+      if ( str_mode == "inelastic/elastic" ) return Kinematics::ProcessMode::InelasticElastic;
+      if ( str_mode == "inelastic/inelastic" ) return Kinematics::ProcessMode::InelasticInelastic;
+      throw Exception( __PRETTY_FUNCTION__, Form( "Unrecognised interaction mode: %s", str_mode.c_str() ), FatalError );
+    }
+
+    StructureFunctions
+    ConfigReader::parseStructureFunctions( const std::string& sf )
+    {
+      if ( sf == "electron" ) return Electron;
+      if ( sf == "elastic proton" ) return ElasticProton;
+      if ( sf == "Suri-Yennie" ) return SuriYennie;
+      if ( sf == "Suri-Yennie;lowQ2" ) return SuriYennieLowQ2;
+      if ( sf == "Szczurek-Uleshchenko" ) return SzczurekUleshchenko;
+      if ( sf == "Fiore;valence" ) return FioreVal;
+      if ( sf == "Fiore;sea" ) return FioreSea;
+      if ( sf == "Fiore" ) return Fiore;
+      throw Exception( __PRETTY_FUNCTION__, Form( "Invalid structure functions mode: %s", sf.c_str() ), FatalError );
+    }
+
     void
     ConfigReader::parseVegas( const libconfig::Setting& veg )
     {
@@ -107,6 +170,11 @@ namespace CepGen
         if ( veg.exists( "num_points" ) ) params_.vegas.npoints = (int)veg["num_points"];
         if ( veg.exists( "num_integration_calls" ) ) params_.vegas.ncvg = (int)veg["num_integration_calls"];
         if ( veg.exists( "num_integration_iterations" ) ) params_.vegas.itvg = (int)veg["num_integration_iterations"];
+        if ( veg.exists( "seed" ) ) params_.vegas.seed = (long long)veg["seed"];
+        if ( veg.exists( "stream" ) ) params_.vegas.stream = (long long)veg["stream"];
+        if ( veg.exists( "num_refinement_points" ) ) params_.vegas.refine_npoints = (int)veg["num_refinement_points"];
+        if ( veg.exists( "target_precision" ) ) params_.vegas.precision = (double)veg["target_precision"];
+        if ( veg.exists( "cache_directory" ) ) params_.vegas.cache_directory = (const char*)veg["cache_directory"];
       } catch ( const libconfig::SettingNotFoundException& nfe ) {
         FatalError( Form( "Failed to retrieve the field \"%s\".", nfe.getPath() ) );
       }
@@ -119,6 +187,10 @@ namespace CepGen
       try {
         if ( gen.exists( "num_events" ) ) params_.generation.maxgen = (int)gen["num_events"];
         if ( gen.exists( "print_every" ) ) params_.generation.gen_print_every = (int)gen["print_every"];
+        if ( gen.exists( "checkpoint_every" ) ) params_.generation.checkpoint_every = (int)gen["checkpoint_every"];
+        if ( gen.exists( "checkpoint_file" ) ) params_.generation.checkpoint_file = (const char*)gen["checkpoint_file"];
+        if ( gen.exists( "metrics_file" ) ) params_.generation.metrics_file = (const char*)gen["metrics_file"];
+        if ( gen.exists( "metrics_period" ) ) params_.generation.metrics_period = (double)gen["metrics_period"];
       } catch ( const libconfig::SettingNotFoundException& nfe ) {
         FatalError( Form( "Failed to retrieve the field \"%s\".", nfe.getPath() ) );
       }
@@ -133,11 +205,29 @@ namespace CepGen
       }
     }
 
+    void
+    ConfigReader::parseHistograms( const libconfig::Setting& hists )
+    {
+      if ( !hists.isList() ) FatalError( "The histograms definition must be wrapped within a list!" );
+      try {
+        for ( unsigned short i = 0; i < hists.getLength(); ++i ) {
+          const libconfig::Setting& hist = hists[i];
+          params_.histograms.emplace_back( (const char*)hist["variable"], (int)hist["num_bins"], (double)hist["min"], (double)hist["max"] );
+        }
+      } catch ( const libconfig::SettingNotFoundException& nfe ) {
+        FatalError( Form( "Failed to retrieve the field \"%s\".", nfe.getPath() ) );
+      } catch ( const libconfig::SettingTypeException& te ) {
+        FatalError( Form( "Field \"%s\" has wrong type.", te.getPath() ) );
+      }
+    }
+
     void
     ConfigReader::writeProcess( const Parameters* params, libconfig::Setting& root )
     {
       libconfig::Setting& proc = root.add( "process", libconfig::Setting::TypeGroup );
       proc.add( "name", libconfig::Setting::TypeString ) = params->processName();
+      const Process::GamGamLL* lpair = dynamic_cast<const Process::GamGamLL*>( params->process() );
+      if ( lpair ) proc.add( "nopt", libconfig::Setting::TypeInt ) = lpair->optimisation();
       std::ostringstream os; os << params->kinematics.mode;
       proc.add( "mode", libconfig::Setting::TypeString ) = os.str();
     }
@@ -149,7 +239,7 @@ namespace CepGen
       kin.add( "beam1_pz", libconfig::Setting::TypeFloat ) = params->kinematics.in1p;
       kin.add( "beam2_pz", libconfig::Setting::TypeFloat ) = params->kinematics.in2p;
       std::ostringstream os; os << params->remnant_mode;
-      kin.add( "structure_function", libconfig::Setting::TypeString ) = os.str();
+      kin.add( "structure_functions", libconfig::Setting::TypeString ) = os.str();
     }
 
     void
@@ -179,6 +269,46 @@ namespace CepGen
       }
     }
 
+    void
+    ConfigReader::writeCocktail( const Parameters* params, libconfig::Setting& root )
+    {
+      if ( params->cocktail.empty() ) return;
+      libconfig::Setting& cocktail = root.add( "cocktail", libconfig::Setting::TypeList );
+      for ( const auto& channel : params->cocktail ) {
+        libconfig::Setting& chan = cocktail.add( libconfig::Setting::TypeGroup );
+        std::ostringstream mode, sf; mode << channel.mode; sf << channel.remnant_mode;
+        chan.add( "mode", libconfig::Setting::TypeString ) = mode.str();
+        chan.add( "structure_functions", libconfig::Setting::TypeString ) = sf.str();
+        chan.add( "pair", libconfig::Setting::TypeInt ) = (int)channel.pair;
+      }
+    }
+
+    void
+    ConfigReader::writeScan( const Parameters* params, libconfig::Setting& root )
+    {
+      if ( params->scan.values.empty() ) return;
+      libconfig::Setting& scan = root.add( "scan", libconfig::Setting::TypeGroup );
+      scan.add( "parameter", libconfig::Setting::TypeString ) = params->scan.parameter;
+      libconfig::Setting& values = scan.add( "values", libconfig::Setting::TypeArray );
+      for ( const auto& val : params->scan.values ) values.add( libconfig::Setting::TypeFloat ) = val;
+      if ( params->scan.num_threads > 0 ) scan.add( "num_threads", libconfig::Setting::TypeInt ) = (int)params->scan.num_threads;
+      scan.add( "warm_start", libconfig::Setting::TypeBoolean ) = params->scan.warm_start;
+    }
+
+    void
+    ConfigReader::writeHistograms( const Parameters* params, libconfig::Setting& root )
+    {
+      if ( params->histograms.empty() ) return;
+      libconfig::Setting& hists = root.add( "histograms", libconfig::Setting::TypeList );
+      for ( const auto& hist : params->histograms ) {
+        libconfig::Setting& def = hists.add( libconfig::Setting::TypeGroup );
+        def.add( "variable", libconfig::Setting::TypeString ) = hist.variable();
+        def.add( "num_bins", libconfig::Setting::TypeInt ) = (int)hist.numBins();
+        def.add( "min", libconfig::Setting::TypeFloat ) = hist.binLow( 0 );
+        def.add( "max", libconfig::Setting::TypeFloat ) = hist.binHigh( hist.numBins()-1 );
+      }
+    }
+
     void
     ConfigReader::writeVegas( const Parameters* params, libconfig::Setting& root )
     {
@@ -186,6 +316,11 @@ namespace CepGen
       veg.add( "num_points", libconfig::Setting::TypeInt ) = (int)params->vegas.npoints;
       veg.add( "num_integration_calls", libconfig::Setting::TypeInt ) = (int)params->vegas.ncvg;
       veg.add( "num_integration_iterations", libconfig::Setting::TypeInt ) = (int)params->vegas.itvg;
+      veg.add( "seed", libconfig::Setting::TypeInt64 ) = (long long)params->vegas.seed;
+      veg.add( "stream", libconfig::Setting::TypeInt64 ) = (long long)params->vegas.stream;
+      veg.add( "num_refinement_points", libconfig::Setting::TypeInt ) = (int)params->vegas.refine_npoints;
+      veg.add( "target_precision", libconfig::Setting::TypeFloat ) = params->vegas.precision;
+      if ( !params->vegas.cache_directory.empty() ) veg.add( "cache_directory", libconfig::Setting::TypeString ) = params->vegas.cache_directory;
     }
 
     void
@@ -195,6 +330,14 @@ namespace CepGen
       libconfig::Setting& gen = root.add( "generator", libconfig::Setting::TypeGroup );
       gen.add( "num_events", libconfig::Setting::TypeInt ) = (int)params->generation.maxgen;
       gen.add( "print_every", libconfig::Setting::TypeInt ) = (int)params->generation.gen_print_every;
+      if ( params->generation.checkpoint_every > 0 ) {
+        gen.add( "checkpoint_every", libconfig::Setting::TypeInt ) = (int)params->generation.checkpoint_every;
+        gen.add( "checkpoint_file", libconfig::Setting::TypeString ) = params->generation.checkpoint_file;
+      }
+      if ( !params->generation.metrics_file.empty() ) {
+        gen.add( "metrics_file", libconfig::Setting::TypeString ) = params->generation.metrics_file;
+        gen.add( "metrics_period", libconfig::Setting::TypeFloat ) = params->generation.metrics_period;
+      }
     }
 
     void
@@ -206,8 +349,16 @@ namespace CepGen
       writeIncomingKinematics( params, root["process"] );
       writeOutgoingKinematics( params, root["process"] );
       writeTamingFunctions( params, root["process"] );
+      writeCocktail( params, root["process"] );
       writeVegas( params, root );
       writeGenerator( params, root );
+      writeScan( params, root );
+      writeHistograms( params, root );
+      if ( !params->report_file.empty() ) root.add( "report_file", libconfig::Setting::TypeString ) = params->report_file;
+      if ( !params->trace_file.empty() ) {
+        root.add( "trace_file", libconfig::Setting::TypeString ) = params->trace_file;
+        root.add( "trace_capacity", libconfig::Setting::TypeInt ) = (int)params->trace_capacity;
+      }
       cfg.writeFile( file );
     }
   }
@@ -27,11 +27,19 @@ namespace CepGen
         void parseVegas( const libconfig::Setting& );
         void parseGenerator( const libconfig::Setting& );
         void parseTamingFunctions( const libconfig::Setting& );
+        void parseCocktail( const libconfig::Setting& );
+        void parseScan( const libconfig::Setting& );
+        void parseHistograms( const libconfig::Setting& );
+        static Kinematics::ProcessMode parseMode( const libconfig::Setting& );
+        static StructureFunctions parseStructureFunctions( const std::string& );
 
         static void writeProcess( const Parameters*, libconfig::Setting& );
         static void writeIncomingKinematics( const Parameters*, libconfig::Setting& );
         static void writeOutgoingKinematics( const Parameters*, libconfig::Setting& );
         static void writeTamingFunctions( const Parameters*, libconfig::Setting& );
+        static void writeCocktail( const Parameters*, libconfig::Setting& );
+        static void writeScan( const Parameters*, libconfig::Setting& );
+        static void writeHistograms( const Parameters*, libconfig::Setting& );
         static void writeVegas( const Parameters*, libconfig::Setting& );
         static void writeGenerator( const Parameters*, libconfig::Setting& );
 #else
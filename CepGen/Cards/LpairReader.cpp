@@ -6,7 +6,8 @@ namespace CepGen
   {
     //----- specialization for LPAIR input cards
 
-    LpairReader::LpairReader( const char* file )
+    LpairReader::LpairReader( const char* file ) :
+      n_opt_( 0 )
     {
       std::ifstream f( file, std::fstream::in );
       if ( !f.is_open() ) {
@@ -22,13 +23,28 @@ namespace CepGen
       std::string key, value;
       while ( f >> key >> value ) {
         if ( key[0] == '#' ) continue; // FIXME need to ensure there is no extra space before!
+        if ( key == "HIST" ) { // differential cross section, as "variable,num_bins,min,max"
+          std::istringstream def( value );
+          std::string var, nbins, min, max;
+          if ( !std::getline( def, var, ',' ) || !std::getline( def, nbins, ',' ) || !std::getline( def, min, ',' ) || !std::getline( def, max ) ) {
+            FatalError( Form( "Invalid histogram definition: \"%s\"", value.c_str() ) );
+          }
+          params_.histograms.emplace_back( var, std::stoi( nbins ), std::stod( min ), std::stod( max ) );
+          os << ">> HIST = " << value << " (Differential cross section)" << std::endl;
+          continue;
+        }
+        if ( key == "NOPT" ) { // signed, hence not among the unsigned integer parameters
+          n_opt_ = std::stoi( value );
+          os << ">> NOPT = " << std::setw( 15 ) << n_opt_ << " (Optimisation of the phase space mappings)" << std::endl;
+          continue;
+        }
         setParameter( key, value );
         m_params.insert( std::pair<std::string,std::string>( key, value ) );
         if ( getDescription( key ) != "null" ) os << ">> " << key << " = " << std::setw( 15 ) << getParameter( key ) << " (" << getDescription( key ) << ")" << std::endl;
       }
       f.close();
 
-      if      ( proc_name_ == "lpair" )  params_.setProcess( new Process::GamGamLL() );
+      if      ( proc_name_ == "lpair" )  params_.setProcess( new Process::GamGamLL( n_opt_ ) );
       else FatalError( Form( "Unrecognised process name: %s", proc_name_.c_str() ) );
 
       if ( m_params.count( "IEND" ) ) setValue<bool>( "IEND", ( std::stoi( m_params["IEND"] ) > 1 ) );
@@ -46,6 +62,7 @@ namespace CepGen
       registerParameter<unsigned int>( "NCVG", "Number of function calls", &params->vegas.ncvg );
       registerParameter<unsigned int>( "NCSG", "Number of points to probe", &params->vegas.npoints );
       registerParameter<unsigned int>( "ITVG", "Number of Vegas iterations", &params->vegas.itvg );
+      registerParameter<unsigned int>( "NRSG", "Number of points to refine a bin maximum", &params->vegas.refine_npoints );
       registerParameter<unsigned int>( "MODE", "Subprocess' mode", (unsigned int*)&params->kinematics.mode );
       registerParameter<unsigned int>( "PMOD", "Outgoing primary particles' mode", (unsigned int*)&params->remnant_mode );
       registerParameter<unsigned int>( "EMOD", "Outgoing primary particles' mode", (unsigned int*)&params->remnant_mode );
@@ -80,6 +97,7 @@ namespace CepGen
       for ( const auto& it : p_ints_ ) { if ( it.second.value ) f << it.first << " = " << *it.second.value << "\n"; }
       for ( const auto& it : p_doubles_ ) { if ( it.second.value ) f << it.first << " = " << *it.second.value << "\n"; }
       for ( const auto& it : p_bools_ ) { if ( it.second.value ) f << it.first << " = " << *it.second.value << "\n"; }
+      if ( n_opt_ != 0 ) f << "NOPT = " << n_opt_ << "\n";
       f.close();
     }
 
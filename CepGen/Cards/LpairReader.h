@@ -39,6 +39,8 @@ namespace CepGen
 
         void init( Parameters* );
         std::string proc_name_, hadr_name_;
+        /// Optimisation of the phase space mappings (see Process::GamGamLL)
+        int n_opt_;
     };
 
     //----- specialised registerers
@@ -0,0 +1,70 @@
+#ifndef CepGen_Core_BoundedQueue_h
+#define CepGen_Core_BoundedQueue_h
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+namespace CepGen
+{
+  /**
+   * A first-in first-out queue with a maximal capacity, to be shared between
+   * a producer and a consumer thread. Pushing into a full queue blocks the
+   * producer until the consumer pops an element (back-pressure).
+   * \date Oct 2026
+   */
+  template<typename T>
+  class BoundedQueue
+  {
+    public:
+      /// Build an empty queue
+      /// \param[in] capacity Maximal number of elements held at any time
+      explicit BoundedQueue( size_t capacity ) : capacity_( capacity ), closed_( false ) {}
+
+      /// Append an element, waiting for a free slot if the queue is full
+      /// \return false if the queue was closed in the meantime
+      bool push( T&& item ) {
+        std::unique_lock<std::mutex> lock( mutex_ );
+        not_full_.wait( lock, [this]{ return closed_ || items_.size() < capacity_; } );
+        if ( closed_ ) return false;
+        items_.emplace_back( std::move( item ) );
+        not_empty_.notify_one();
+        return true;
+      }
+      /// Retrieve the oldest element, waiting for one to be pushed if the queue is empty
+      /// \return false if the queue is closed and fully drained
+      bool pop( T& item ) {
+        std::unique_lock<std::mutex> lock( mutex_ );
+        not_empty_.wait( lock, [this]{ return closed_ || !items_.empty(); } );
+        if ( items_.empty() ) return false;
+        item = std::move( items_.front() );
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+      }
+      /// Stop accepting new elements and wake up all waiting threads
+      /// \note Elements already queued can still be popped
+      void close() {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+      }
+      /// Number of elements currently held
+      size_t size() const {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        return items_.size();
+      }
+      /// Maximal number of elements to be held
+      size_t capacity() const { return capacity_; }
+
+    private:
+      mutable std::mutex mutex_;
+      std::condition_variable not_full_, not_empty_;
+      std::deque<T> items_;
+      size_t capacity_;
+      bool closed_;
+  };
+}
+
+#endif
@@ -0,0 +1,133 @@
+#include "CepGen/Core/Checkpoint.h"
+
+#include <cstdlib>
+
+namespace CepGen
+{
+  namespace
+  {
+    /// Version of the checkpoint files layout
+    constexpr unsigned short kCheckpointVersion = 6;
+
+    /// Exact (hexadecimal) representation of a floating point value
+    std::string exact( double val ) { return Form( "%a", val ); }
+
+    /// Read the next field of a checkpoint file, ensuring its key is the expected one
+    std::istream& field( std::istream& is, const char* key, const std::string& file, ExceptionType type=FatalError ) {
+      std::string read_key;
+      if ( !( is >> read_key ) || read_key != key ) {
+        throw Exception( __PRETTY_FUNCTION__, Form( "Failed to retrieve the field \"%s\" from checkpoint file \"%s\"", key, file.c_str() ), type );
+      }
+      return is;
+    }
+    double readDouble( std::istream& is ) {
+      std::string val; is >> val;
+      return std::strtod( val.c_str(), nullptr );
+    }
+    template<typename T> void writeVector( std::ostream& os, const char* key, const std::vector<T>& vec ) {
+      os << key << " " << vec.size();
+      for ( const auto& val : vec ) os << " " << val;
+      os << "\n";
+    }
+    template<typename T> void readVector( std::istream& is, const char* key, std::vector<T>& vec, const std::string& file, ExceptionType type ) {
+      size_t size = 0;
+      field( is, key, file, type ) >> size;
+      vec.resize( size );
+      for ( auto& val : vec ) is >> val;
+    }
+  }
+
+  Checkpoint::Checkpoint() :
+    seed( 0 ), stream( 0 ), num_dimensions( 0 ), cross_section( -1. ), cross_section_error( -1. ),
+    ngen( 0 ), process_rng_position( 0 ), output_position( -1 ), vegas(), selection_rng_position( 0 )
+  {}
+
+  void
+  Checkpoint::save( const std::string& file ) const
+  {
+    if ( !writeAtomically( file, [this]( std::ostream& out ) { write( out ); } ) ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Failed to write checkpoint file \"%s\"", file.c_str() ), JustWarning );
+    }
+    Debugging( Form( "Checkpoint written in \"%s\" after %d events", file.c_str(), ngen ) );
+  }
+
+  void
+  Checkpoint::write( std::ostream& out ) const
+  {
+    out
+      << "cepgen_checkpoint " << kCheckpointVersion << "\n"
+      << "seed " << seed << " " << stream << "\n"
+      << "dimensions " << num_dimensions << "\n"
+      << "cross_section " << exact( cross_section ) << " " << exact( cross_section_error ) << "\n"
+      << "ngen " << ngen << "\n"
+      << "process_rng " << process_rng_position << "\n"
+      << "output_position " << output_position << "\n"
+      << "vegas_rng " << vegas.rng_position << "\n"
+      << "vegas_bin " << vegas.vegas_bin << " " << vegas.correcting << "\n"
+      << "correction "
+      << exact( vegas.correc ) << " " << exact( vegas.correc2 ) << " " << exact( vegas.f_max2 ) << " "
+      << exact( vegas.f_max_diff ) << " " << exact( vegas.f_max_old ) << " " << exact( vegas.f_max_global ) << "\n";
+    std::vector<std::string> f_max;
+    for ( const auto& val : vegas.f_max ) f_max.emplace_back( exact( val ) );
+    writeVector( out, "f_max", f_max );
+    writeVector( out, "nm", vegas.nm );
+    writeVector( out, "n", vegas.n );
+    writeVector( out, "overshoots", vegas.overshoots );
+    out << "refinement " << vegas.refined_bin << " " << vegas.refine_left << " " << exact( vegas.refine_max ) << "\n";
+    out << "channels " << channels.size() << " " << selection_rng_position << "\n";
+    for ( const auto& chan : channels ) chan.write( out );
+  }
+
+  Checkpoint
+  Checkpoint::load( const std::string& file )
+  {
+    std::ifstream in( file );
+    if ( !in.is_open() ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Failed to open checkpoint file \"%s\"", file.c_str() ), FatalError );
+    }
+    return read( in, file );
+  }
+
+  Checkpoint
+  Checkpoint::read( std::istream& in, const std::string& file, ExceptionType error_type )
+  {
+    Checkpoint out;
+    unsigned short version = 0;
+    field( in, "cepgen_checkpoint", file, error_type ) >> version;
+    if ( version != kCheckpointVersion ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Unsupported checkpoint file version: %d", version ), error_type );
+    }
+    field( in, "seed", file, error_type ) >> out.seed >> out.stream;
+    field( in, "dimensions", file, error_type ) >> out.num_dimensions;
+    field( in, "cross_section", file, error_type );
+    out.cross_section = readDouble( in );
+    out.cross_section_error = readDouble( in );
+    field( in, "ngen", file, error_type ) >> out.ngen;
+    field( in, "process_rng", file, error_type ) >> out.process_rng_position;
+    field( in, "output_position", file, error_type ) >> out.output_position;
+    field( in, "vegas_rng", file, error_type ) >> out.vegas.rng_position;
+    field( in, "vegas_bin", file, error_type ) >> out.vegas.vegas_bin >> out.vegas.correcting;
+    field( in, "correction", file, error_type );
+    out.vegas.correc = readDouble( in );
+    out.vegas.correc2 = readDouble( in );
+    out.vegas.f_max2 = readDouble( in );
+    out.vegas.f_max_diff = readDouble( in );
+    out.vegas.f_max_old = readDouble( in );
+    out.vegas.f_max_global = readDouble( in );
+    std::vector<std::string> f_max;
+    readVector( in, "f_max", f_max, file, error_type );
+    for ( const auto& val : f_max ) out.vegas.f_max.emplace_back( std::strtod( val.c_str(), nullptr ) );
+    readVector( in, "nm", out.vegas.nm, file, error_type );
+    readVector( in, "n", out.vegas.n, file, error_type );
+    readVector( in, "overshoots", out.vegas.overshoots, file, error_type );
+    field( in, "refinement", file, error_type ) >> out.vegas.refined_bin >> out.vegas.refine_left;
+    out.vegas.refine_max = readDouble( in );
+    size_t num_channels = 0;
+    field( in, "channels", file, error_type ) >> num_channels >> out.selection_rng_position;
+    for ( size_t i=0; i<num_channels && in.good(); i++ ) out.channels.emplace_back( read( in, file, error_type ) );
+    if ( in.fail() ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Corrupted checkpoint file \"%s\"", file.c_str() ), error_type );
+    }
+    return out;
+  }
+}
@@ -0,0 +1,58 @@
+#ifndef CepGen_Core_Checkpoint_h
+#define CepGen_Core_Checkpoint_h
+
+#include "CepGen/Core/Vegas.h"
+
+#include <string>
+#include <vector>
+
+namespace CepGen
+{
+  /**
+   * Full state of an events generation run, allowing a preempted job to be
+   * resumed from the last checkpoint with the exact same random sequences.
+   * \date Oct 2026
+   */
+  struct Checkpoint
+  {
+    Checkpoint();
+    /// Write the checkpoint into a file
+    /// \note The file is written under a temporary name, then renamed, so that a
+    ///  previous checkpoint is never left half-overwritten
+    void save( const std::string& file ) const;
+    /// Read a checkpoint from a file
+    static Checkpoint load( const std::string& file );
+    /// Write the checkpoint into a stream
+    void write( std::ostream& os ) const;
+    /// Read a checkpoint from a stream
+    /// \param[in] is Stream to read
+    /// \param[in] file Name of the stream's source, for the error messages
+    /// \param[in] error_type Type of the exception thrown if the stream is invalid
+    static Checkpoint read( std::istream& is, const std::string& file, ExceptionType error_type=FatalError );
+
+    /// Seed of the random numbers sequences used in the run
+    unsigned long long seed;
+    /// Index of the first random numbers stream used in the run
+    unsigned long long stream;
+    /// Number of dimensions of the integration
+    unsigned int num_dimensions;
+    /// Cross section computed at the integration step
+    double cross_section;
+    /// Error on the cross section computed at the integration step
+    double cross_section_error;
+    /// Number of events generated at the checkpoint time
+    unsigned int ngen;
+    /// Position in the process' random numbers stream
+    unsigned long long process_rng_position;
+    /// Size of the output written by the caller at the checkpoint time (-1 if unknown)
+    long long output_position;
+    /// Generation state of the integrator
+    Vegas::GenerationState vegas;
+    /// Position in the channels selection random numbers stream (cocktail runs only)
+    unsigned long long selection_rng_position;
+    /// Generation state of each channel (cocktail runs only)
+    std::vector<Checkpoint> channels;
+  };
+}
+
+#endif
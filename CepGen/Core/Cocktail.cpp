@@ -0,0 +1,179 @@
+#include "CepGen/Core/Cocktail.h"
+
+#include <cmath>
+
+namespace CepGen
+{
+  Cocktail::Cocktail( Parameters& params ) :
+    trace_session_( params.trace_file, params.trace_capacity ), report_file_( params.report_file ),
+    stream_( params.vegas.stream ), rng_( params.vegas.seed, params.vegas.stream+2 ),
+    cross_section_( -1. ), cross_section_error_( -1. ), last_channel_( 0 ), ngen_( 0 )
+  {
+    if ( params.cocktail.empty() ) {
+      throw Exception( __PRETTY_FUNCTION__, "No channel defined for the cocktail!", FatalError );
+    }
+    if ( !params.process() ) {
+      throw Exception( __PRETTY_FUNCTION__, "No process defined!", FatalError );
+    }
+    const Parameters& common = params;
+    for ( unsigned short i=0; i<params.cocktail.size(); i++ ) {
+      const Parameters::CocktailChannel& chan = params.cocktail[i];
+      Parameters* ch_params = new Parameters( common ); // all but the process
+      ch_params->setProcess( params.process()->clone() );
+      ch_params->kinematics.mode = chan.mode;
+      ch_params->kinematics.remnant_mode = ch_params->remnant_mode = chan.remnant_mode;
+      ch_params->kinematics.pair = chan.pair;
+      ch_params->vegas.stream = stream_+3+2*i; // independent random sequences for all channels
+      ch_params->cocktail.clear();
+      //--- the report and the timeline cover the whole cocktail
+      ch_params->report_file.clear();
+      ch_params->trace_file.clear();
+      channels_.emplace_back( new Generator( ch_params ) );
+    }
+    if ( trace_session_.recording() ) Tracer::get().setThreadName( "cocktail" );
+  }
+
+  Cocktail::~Cocktail()
+  {
+    if ( report_file_.empty() ) return;
+    try { report().write( report_file_ ); } catch ( Exception& e ) { e.dump(); }
+  }
+
+  void
+  Cocktail::computeXsection( double& xsec, double& err )
+  {
+    for ( auto& chan : channels_ ) {
+      double ch_xsec, ch_err;
+      chan->computeXsection( ch_xsec, ch_err );
+    }
+    computeFractions();
+    xsec = cross_section_;
+    err = cross_section_error_;
+  }
+
+  void
+  Cocktail::computeFractions()
+  {
+    double xsec = 0., err = 0.;
+    for ( const auto& chan : channels_ ) {
+      xsec += std::max( chan->crossSection(), 0. );
+      err += chan->crossSectionError()*chan->crossSectionError();
+    }
+    if ( xsec <= 0. ) {
+      throw Exception( __PRETTY_FUNCTION__, "Null cross section for all channels of the cocktail!", FatalError );
+    }
+    fractions_.clear();
+    double sum = 0.;
+    std::ostringstream os;
+    for ( unsigned short i=0; i<channels_.size(); i++ ) {
+      const double ch_xsec = std::max( channels_[i]->crossSection(), 0. );
+      sum += ch_xsec;
+      fractions_.emplace_back( sum/xsec );
+      std::ostringstream mode; mode << channels_[i]->parameters->kinematics.mode;
+      os << Form( "\n\t  channel %d (%s): %f pb (%.2f%%)", i, mode.str().c_str(), ch_xsec, ch_xsec/xsec*100. );
+    }
+    cross_section_ = xsec;
+    cross_section_error_ = sqrt( err );
+
+    Information( Form( "Total cross section for the cocktail: %f +/- %f pb%s", cross_section_, cross_section_error_, os.str().c_str() ) );
+  }
+
+  RunReport
+  Cocktail::report()
+  {
+    RunReport out;
+    std::string description;
+    out.integration_restored = true;
+    for ( auto& chan : channels_ ) {
+      const RunReport ch = chan->report();
+      description += IntegrationCache::description( *chan->parameters );
+      out.process = ch.process;
+      out.num_dimensions = std::max( out.num_dimensions, ch.num_dimensions );
+      out.integration_restored = out.integration_restored && ch.integration_restored;
+      const double weight = ( cross_section_ > 0. ) ? std::max( ch.cross_section, 0. )/cross_section_ : 0.;
+      out.vegas.num_iterations = std::max( out.vegas.num_iterations, ch.vegas.num_iterations );
+      out.vegas.chi2 += weight*ch.vegas.chi2;
+      out.vegas.integration_calls += ch.vegas.integration_calls;
+      out.vegas.integration_time += ch.vegas.integration_time;
+      out.vegas.grid_calls += ch.vegas.grid_calls;
+      out.vegas.grid_time += ch.vegas.grid_time;
+      out.vegas.grid_efficiency += weight*ch.vegas.grid_efficiency;
+      out.vegas.num_sampled += ch.vegas.num_sampled;
+      out.vegas.sampling_calls += ch.vegas.sampling_calls;
+      out.vegas.sampling_time += ch.vegas.sampling_time;
+      out.events_time += ch.events_time;
+      out.num_function_calls += ch.num_function_calls;
+      out.peak_memory = std::max( out.peak_memory, ch.peak_memory );
+    }
+    out.configuration_hash = IntegrationCache::hash( description );
+    out.seed = rng_.seed();
+    out.cross_section = cross_section_;
+    out.cross_section_error = cross_section_error_;
+    out.num_events = ngen_;
+    out.wall_time = run_timer_.elapsed();
+    return out;
+  }
+
+  std::vector<Generator*>
+  Cocktail::channels()
+  {
+    std::vector<Generator*> out;
+    for ( auto& chan : channels_ ) out.emplace_back( chan.get() );
+    return out;
+  }
+
+  unsigned short
+  Cocktail::nextChannel()
+  {
+    if ( fractions_.empty() ) computeXsection( cross_section_, cross_section_error_ );
+    const double y = rng_.uniform();
+    last_channel_ = std::lower_bound( fractions_.begin(), fractions_.end(), y )-fractions_.begin();
+    if ( last_channel_ >= channels_.size() ) last_channel_ = channels_.size()-1; // rounding errors
+    ngen_++;
+    return last_channel_;
+  }
+
+  Event*
+  Cocktail::generateOneEvent()
+  {
+    return channels_[nextChannel()]->generateOneEvent();
+  }
+
+  EventStream
+  Cocktail::events( unsigned long num_events, unsigned int batch_size )
+  {
+    //--- integrate all channels beforehand so that the production thread only deals with the unweighting
+    if ( fractions_.empty() ) computeXsection( cross_section_, cross_section_error_ );
+    return EventStream( *this, num_events, batch_size );
+  }
+
+  Checkpoint
+  Cocktail::checkpoint()
+  {
+    if ( fractions_.empty() ) computeXsection( cross_section_, cross_section_error_ );
+    Checkpoint out;
+    out.seed = rng_.seed();
+    out.stream = stream_;
+    out.cross_section = cross_section_;
+    out.cross_section_error = cross_section_error_;
+    out.ngen = ngen_;
+    out.selection_rng_position = rng_.position();
+    for ( auto& chan : channels_ ) out.channels.emplace_back( chan->checkpoint() );
+    return out;
+  }
+
+  Checkpoint
+  Cocktail::resume( const std::string& file )
+  {
+    const Checkpoint ckpt = Checkpoint::load( file );
+    if ( ckpt.seed != rng_.seed() || ckpt.stream != stream_ || ckpt.channels.size() != channels_.size() ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Checkpoint \"%s\" (seed %llu, stream %llu, %zu channels) does not match the cocktail (seed %llu, stream %llu, %zu channels)!", file.c_str(), ckpt.seed, ckpt.stream, ckpt.channels.size(), rng_.seed(), stream_, channels_.size() ), FatalError );
+    }
+    for ( unsigned short i=0; i<channels_.size(); i++ ) channels_[i]->resume( ckpt.channels[i] );
+    rng_.seek( ckpt.selection_rng_position );
+    ngen_ = ckpt.ngen;
+    computeFractions();
+    Information( Form( "Cocktail run resumed from checkpoint \"%s\" after %d events", file.c_str(), ckpt.ngen ) );
+    return ckpt;
+  }
+}
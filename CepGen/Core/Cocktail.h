@@ -0,0 +1,105 @@
+#ifndef CepGen_Core_Cocktail_h
+#define CepGen_Core_Cocktail_h
+
+#include "CepGen/Generator.h"
+
+#include <vector>
+#include <memory>
+
+namespace CepGen
+{
+  /**
+   * Several channels (process modes, structure functions, produced pair) of a
+   * process, integrated once each, then generated together in a single stream
+   * of events. The channel of each event is picked according to its fraction of
+   * the total cross section.
+   * \note Each channel is handled by its own Generator object. All of them share
+   *  the seed of the run, but draw from their own random numbers streams: the
+   *  channels selection uses the stream following the ones of a single channel
+   *  run, and channel i the pair of streams starting at 3+2i (on top of the first
+   *  stream of the run, see Parameters::Vegas::stream)
+   * \note The run report and the timeline requested in the parameters cover the
+   *  whole cocktail: they are written once, when the cocktail is destroyed, and
+   *  never by the channels themselves
+   * \date Oct 2026
+   */
+  class Cocktail
+  {
+    public:
+      /// Book all channels listed in the @a cocktail member of the run parameters
+      /// \param[in] params Run parameters common to all channels (the process is replicated for each channel)
+      explicit Cocktail( Parameters& params );
+      /// Write the run report of the cocktail (if requested in the parameters)
+      ~Cocktail();
+
+      /// Compute the cross section of each channel, and the total one
+      /// \param[out] xsec The total cross section, in pb
+      /// \param[out] err The absolute integration error on the total cross section, in pb
+      void computeXsection( double& xsec, double& err );
+      double crossSection() const { return cross_section_; }
+      double crossSectionError() const { return cross_section_error_; }
+      /// Generate one event in a channel picked according to its cross section
+      /// \return A pointer to the Event object generated (owned by the channel's process)
+      Event* generateOneEvent();
+      /**
+       * Book a range of unweighted events mixing all channels, produced ahead of their
+       * consumption (see Generator::events and EventStream)
+       * \param[in] num_events Number of events to produce
+       * \param[in] batch_size Number of events produced and handed over to the caller in one go
+       */
+      EventStream events( unsigned long num_events, unsigned int batch_size=100 );
+      /// Pick the channel of the next event according to the cross sections (computed if needed)
+      unsigned short nextChannel();
+      /// Number of events generated in all channels
+      unsigned int numGenerated() const { return ngen_; }
+
+      /// Snapshot of the current events generation state of all channels
+      Checkpoint checkpoint();
+      /**
+       * Restore the events generation state of all channels from a checkpoint file
+       * written during a cocktail run with the same channels
+       * \param[in] file Path to the checkpoint file
+       * \return The checkpoint restored (number of events generated, output size, ...)
+       */
+      Checkpoint resume( const std::string& file );
+
+      /// Number of channels in the cocktail
+      size_t numChannels() const { return channels_.size(); }
+      /// Generator handling one channel of the cocktail
+      Generator& channel( unsigned short i ) { return *channels_.at( i ); }
+      /// Generators handling all channels of the cocktail
+      std::vector<Generator*> channels();
+      /// Index of the channel in which the last event was generated
+      unsigned short lastChannel() const { return last_channel_; }
+      /**
+       * Summary of the cocktail run so far, aggregating the ones of all channels: the
+       * counters and timings are summed, the \f$\chi^2\f$ and the grid efficiency
+       * averaged with the channels cross sections as weights
+       */
+      RunReport report();
+
+    private:
+      /// Compute the cumulative fractions of the total cross section from the channels ones
+      void computeFractions();
+
+      /// Recording of the timeline of the cocktail run (if requested)
+      Tracer::Session trace_session_;
+      /// Path to the run report written at the end of the cocktail run (if any)
+      const std::string report_file_;
+      std::vector<std::unique_ptr<Generator> > channels_;
+      /// Cumulative fractions of the total cross section of all channels
+      std::vector<double> fractions_;
+      /// First random numbers stream of the run
+      const unsigned long long stream_;
+      /// Random numbers generator for the selection of the channels
+      RandomGenerator rng_;
+      double cross_section_, cross_section_error_;
+      unsigned short last_channel_;
+      /// Number of events generated in all channels
+      unsigned int ngen_;
+      /// Time since the construction of this object
+      Timer run_timer_;
+  };
+}
+
+#endif
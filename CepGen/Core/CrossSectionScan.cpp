@@ -0,0 +1,127 @@
+#include "CepGen/Core/CrossSectionScan.h"
+#include "CepGen/Generator.h"
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+namespace CepGen
+{
+  CrossSectionScan::CrossSectionScan( Parameters& params ) :
+    params_( params )
+  {
+    if ( !params.process() ) {
+      throw Exception( __PRETTY_FUNCTION__, "No process defined!", FatalError );
+    }
+    if ( params.scan.values.empty() ) {
+      throw Exception( __PRETTY_FUNCTION__, "No value given for the cross section scan!", FatalError );
+    }
+    //--- ensure the parameter name is valid before launching anything
+    Parameters test( static_cast<const Parameters&>( params ) );
+    setParameter( test, params.scan.parameter, params.scan.values[0] );
+    for ( const auto& val : params.scan.values ) points_.emplace_back( val );
+  }
+
+  void
+  CrossSectionScan::setParameter( Parameters& params, const std::string& name, double value )
+  {
+    Kinematics& kin = params.kinematics;
+    if ( name == "pt_min" ) kin.pt_min = value;
+    else if ( name == "pt_max" ) kin.pt_max = value;
+    else if ( name == "e_min" ) kin.e_min = value;
+    else if ( name == "e_max" ) kin.e_max = value;
+    else if ( name == "eta_min" ) kin.eta_min = value;
+    else if ( name == "eta_max" ) kin.eta_max = value;
+    else if ( name == "mass_min" ) kin.mass_min = value;
+    else if ( name == "mass_max" ) kin.mass_max = value;
+    else if ( name == "mx_min" ) kin.mx_min = value;
+    else if ( name == "mx_max" ) kin.mx_max = value;
+    else if ( name == "q2_min" ) kin.q2_min = value;
+    else if ( name == "q2_max" ) kin.q2_max = value;
+    else if ( name == "w_min" ) kin.w_min = value;
+    else if ( name == "w_max" ) kin.w_max = value;
+    else if ( name == "sqrt_s" ) kin.setSqrtS( value );
+    else throw Exception( __PRETTY_FUNCTION__, Form( "Invalid parameter to scan: \"%s\"", name.c_str() ), FatalError );
+  }
+
+  const std::vector<CrossSectionScan::Point>&
+  CrossSectionScan::run()
+  {
+    unsigned short num_threads = params_.scan.num_threads;
+    if ( num_threads == 0 ) num_threads = std::max( std::thread::hardware_concurrency(), 1u );
+    num_threads = std::min<size_t>( num_threads, points_.size() );
+
+    Information( Form( "Scanning the cross section for %zu values of %s, in %d thread(s)", points_.size(), params_.scan.parameter.c_str(), num_threads ) );
+
+    //--- list of ranges of points computed in a row, each point starting from the grid adapted
+    //    for the previous one in warm-start mode (thus one contiguous range per thread)
+    std::vector<std::pair<size_t,size_t> > ranges;
+    const size_t num_ranges = ( params_.scan.warm_start ) ? num_threads : points_.size();
+    for ( size_t i=0; i<num_ranges; i++ ) ranges.emplace_back( i*points_.size()/num_ranges, ( i+1 )*points_.size()/num_ranges );
+
+    //--- each thread picks the next range not yet computed
+    std::atomic<size_t> next_range( 0 );
+    std::atomic<bool> stop( false );
+    std::mutex mutex;
+    std::exception_ptr error;
+    std::vector<std::thread> threads;
+    const Parameters& common = params_;
+    const Logger& logger = Logger::get();
+    //--- one timeline for the whole scan (if requested)
+    Tracer::Session trace_session( params_.trace_file, params_.trace_capacity );
+    for ( unsigned short i=0; i<num_threads; i++ ) {
+      threads.emplace_back( [&]() {
+        Logger::inherit( logger );
+        Tracer::get().setThreadName( "scan worker" );
+        try {
+          for ( size_t j=next_range++; j<ranges.size(); j=next_range++ ) {
+            Vegas::Grid grid;
+            for ( size_t k=ranges[j].first; k<ranges[j].second && !stop; k++ ) {
+              Point& point = points_[k];
+              Parameters* params = new Parameters( common ); // all but the process
+              {
+                std::lock_guard<std::mutex> lock( mutex );
+                params->setProcess( params_.process()->clone() );
+              }
+              params->generation.enabled = false;
+              params->scan = Parameters::Scan();
+              //--- no report nor timeline for the individual points
+              params->report_file.clear();
+              params->trace_file.clear();
+              setParameter( *params, params_.scan.parameter, point.value );
+              Generator gen( params );
+              if ( grid.bins > 0 ) gen.setIntegrationGrid( grid );
+              Timer tmr;
+              gen.computeXsection( point.cross_section, point.cross_section_error );
+              point.time = tmr.elapsed();
+              point.num_calls = gen.numFunctionCalls();
+              point.warm_started = ( grid.bins > 0 );
+              if ( params_.scan.warm_start ) grid = gen.integrationGrid();
+            }
+          }
+        } catch ( ... ) {
+          std::lock_guard<std::mutex> lock( mutex );
+          if ( !error ) error = std::current_exception();
+          next_range = ranges.size(); // stop all threads
+          stop = true;
+        }
+      } );
+    }
+    for ( auto& thr : threads ) thr.join();
+    if ( error ) std::rethrow_exception( error );
+
+    unsigned long long num_calls = 0;
+    for ( const auto& point : points_ ) num_calls += point.num_calls;
+    Information( Form( "Scan completed with %llu function calls in total (%.0f per point)", num_calls, (double)num_calls/points_.size() ) );
+    return points_;
+  }
+
+  void
+  CrossSectionScan::write( std::ostream& os ) const
+  {
+    os << "# " << params_.scan.parameter << "\txsec (pb)\terror (pb)\tcalls\ttime (s)\twarm start\n";
+    for ( const auto& point : points_ ) {
+      os << Form( "%g\t%.6e\t%.6e\t%llu\t%.3f\t%d\n", point.value, point.cross_section, point.cross_section_error, point.num_calls, point.time, point.warm_started );
+    }
+  }
+}
@@ -0,0 +1,60 @@
+#ifndef CepGen_Core_CrossSectionScan_h
+#define CepGen_Core_CrossSectionScan_h
+
+#include "CepGen/Parameters.h"
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+namespace CepGen
+{
+  /**
+   * Computation of the cross section for a list of values of one run parameter.
+   * The points are computed concurrently, each by an independent Generator
+   * object (with its own replica of the process), so that all the cores of the
+   * machine are used. In warm-start mode, each thread computes a contiguous
+   * range of points, each starting from the grid adapted for its neighbour.
+   * \date Oct 2026
+   */
+  class CrossSectionScan
+  {
+    public:
+      /// Result of the integration for one value of the parameter
+      struct Point
+      {
+        Point( double val=0. ) : value( val ), cross_section( -1. ), cross_section_error( -1. ), num_calls( 0 ), time( 0. ), warm_started( false ) {}
+        /// Value of the parameter scanned
+        double value;
+        /// Cross section computed, in pb
+        double cross_section;
+        /// Absolute integration error on the cross section, in pb
+        double cross_section_error;
+        /// Number of function evaluations
+        unsigned long long num_calls;
+        /// Wall time for the integration, in seconds
+        double time;
+        /// Was the integration started from the grid adapted for the previous point?
+        bool warm_started;
+      };
+      /// Book a scan of the parameter given in the @a scan member of the run parameters
+      /// \param[in] params Run parameters common to all points (the process is replicated for each point)
+      explicit CrossSectionScan( Parameters& params );
+
+      /// Set the value of a parameter (pt_min, pt_max, e_min, e_max, eta_min, eta_max, mass_min, mass_max, mx_min, mx_max, q2_min, q2_max, w_min, w_max, sqrt_s)
+      static void setParameter( Parameters& params, const std::string& name, double value );
+
+      /// Compute the cross section for all points of the scan
+      const std::vector<Point>& run();
+      /// Results of the scan
+      const std::vector<Point>& points() const { return points_; }
+      /// Write the results of the scan as a tab-separated table (value, cross section, error, calls, time, warm start)
+      void write( std::ostream& os ) const;
+
+    private:
+      Parameters& params_;
+      std::vector<Point> points_;
+  };
+}
+
+#endif
@@ -0,0 +1,207 @@
+#include "CepGen/Core/EventStream.h"
+#include "CepGen/Core/Cocktail.h"
+#include "CepGen/Generator.h"
+
+#include <algorithm>
+
+namespace CepGen
+{
+  EventStream::EventStream( Generator& gen, unsigned long num_events, unsigned int batch_size, unsigned int num_batches ) :
+    EventStream( std::vector<Generator*>( 1, &gen ), nullptr, num_events, batch_size, num_batches )
+  {}
+
+  EventStream::EventStream( Cocktail& cocktail, unsigned long num_events, unsigned int batch_size, unsigned int num_batches ) :
+    EventStream( cocktail.channels(), &cocktail, num_events, batch_size, num_batches )
+  {}
+
+  EventStream::EventStream( const std::vector<Generator*>& gens, Cocktail* cocktail, unsigned long num_events, unsigned int batch_size, unsigned int num_batches ) :
+    gens_( gens ), cocktail_( cocktail ), num_events_( num_events ), batch_size_( std::max( batch_size, 1u ) ),
+    //--- all channels share the generation parameters of the cocktail
+    checkpoint_every_( gens.at( 0 )->parameters->generation.checkpoint_every ), checkpoint_file_( gens[0]->parameters->generation.checkpoint_file ),
+    metrics_file_( gens[0]->parameters->generation.metrics_file ), metrics_period_( gens[0]->parameters->generation.metrics_period ),
+    pipeline_( new Pipeline( std::max( num_batches, 1u ) ) ),
+    pos_( 0 ), num_consumed_( 0 )
+  {}
+
+  EventStream::~EventStream()
+  {
+    if ( !pipeline_ ) return; // moved-from stream
+    pipeline_->stop = true;
+    //--- unblock the stages waiting for a free slot
+    pipeline_->points.close();
+    pipeline_->events.close();
+    if ( sampler_.joinable() ) sampler_.join();
+    if ( materialiser_.joinable() ) materialiser_.join();
+    metrics_.reset(); // last snapshot of the metrics
+    Profiler::get().summary( "events generation" );
+    //--- the next events will continue the random sequences of the replicas
+    for ( size_t i=0; i<replicas_.size(); i++ ) {
+      gens_[i]->parameters->process()->setRandomGenerator( replicas_[i]->process->randomGenerator() );
+    }
+  }
+
+  EventStream::iterator
+  EventStream::begin()
+  {
+    if ( sampler_.joinable() || num_consumed_ > 0 ) {
+      throw Exception( __PRETTY_FUNCTION__, "Event streams can only be iterated once!", JustWarning );
+    }
+    if ( num_events_ == 0 ) return end();
+    std::vector<IntegrandContext*> contexts;
+    for ( const auto& gen : gens_ ) {
+      replicas_.emplace_back( gen->replicaContext() );
+      contexts.emplace_back( replicas_.back().get() );
+    }
+    sampler_ = std::thread( &EventStream::sample, gens_, cocktail_, pipeline_.get(), num_events_, batch_size_, checkpoint_every_ );
+    materialiser_ = std::thread( &EventStream::materialise, gens_, pipeline_.get(), contexts );
+    if ( !metrics_file_.empty() ) {
+      const Pipeline* pipe = pipeline_.get();
+      const unsigned long num_events = num_events_;
+      metrics_.reset( new MetricsExporter( metrics_file_, metrics_period_, [pipe,num_events]() { return pipe->metrics( num_events ); } ) );
+    }
+    if ( !fetch() ) return end();
+    num_consumed_ = 1;
+    return iterator( this );
+  }
+
+  bool
+  EventStream::next()
+  {
+    if ( ++pos_ >= chunk_.events.size() && !fetch() ) return false;
+    ++num_consumed_;
+    return true;
+  }
+
+  bool
+  EventStream::fetch()
+  {
+    //--- all events of the previous batch were processed by the caller
+    pipeline_->num_consumed = num_consumed_;
+    if ( output_size_ ) pipeline_->output_size = output_size_();
+    if ( chunk_.checkpoint ) {
+      if ( sync_ ) chunk_.checkpoint->output_position = sync_();
+      try { chunk_.checkpoint->save( checkpoint_file_ ); } catch ( Exception& e ) { e.dump(); }
+    }
+    pos_ = 0;
+    chunk_ = Chunk();
+    bool fetched = false;
+    { TraceRegion( "wait for events" ); fetched = pipeline_->events.pop( chunk_ ); }
+    if ( fetched && !chunk_.events.empty() ) return true;
+    //--- production is over; propagate its failure (if any) to the caller
+    if ( pipeline_->sampling_error ) std::rethrow_exception( pipeline_->sampling_error );
+    if ( pipeline_->materialisation_error ) std::rethrow_exception( pipeline_->materialisation_error );
+    return false;
+  }
+
+  void
+  EventStream::sample( std::vector<Generator*> gens, Cocktail* cocktail, Pipeline* pipe, unsigned long num_events, unsigned int batch_size, unsigned int checkpoint_every )
+  {
+    Logger::inherit( pipe->logger );
+    Tracer::get().setThreadName( "sampler" );
+    try {
+      //--- number of events generated in the run (including the ones before a resumption)
+      const auto ngen = [&gens,&cocktail]() -> unsigned int {
+        return ( cocktail ) ? cocktail->numGenerated() : gens[0]->parameters->generation.ngen;
+      };
+      const auto num_calls = [&gens]() {
+        unsigned long long out = 0;
+        for ( const auto& gen : gens ) out += gen->numFunctionCalls();
+        return out;
+      };
+      const unsigned long long calls_start = num_calls();
+      std::vector<double> x;
+      unsigned long num_sampled = 0;
+      while ( num_sampled < num_events && !pipe->stop ) {
+        size_t num_in_batch = std::min<unsigned long>( batch_size, num_events-num_sampled );
+        //--- ensure the batch ends at the next checkpoint
+        if ( checkpoint_every > 0 ) num_in_batch = std::min<size_t>( num_in_batch, checkpoint_every-ngen()%checkpoint_every );
+        PointsChunk chunk;
+        TraceRegion( "points batch" );
+        while ( chunk.num_points < num_in_batch && !pipe->stop ) {
+          unsigned short chan = 0;
+          if ( cocktail ) {
+            chan = cocktail->nextChannel();
+            chunk.channels.emplace_back( chan );
+          }
+          gens[chan]->samplePoint( x );
+          chunk.coordinates.insert( chunk.coordinates.end(), x.begin(), x.end() );
+          chunk.num_points++;
+        }
+        num_sampled += chunk.num_points;
+        pipe->num_sampled = num_sampled;
+        pipe->num_trials = num_calls()-calls_start;
+        if ( checkpoint_every > 0 && ngen() % checkpoint_every == 0 ) {
+          chunk.checkpoint.reset( new Checkpoint( ( cocktail ) ? cocktail->checkpoint() : gens[0]->checkpoint() ) );
+        }
+        TraceRegion( "wait for a free points slot" );
+        if ( !pipe->points.push( std::move( chunk ) ) ) break; // stream destroyed in the meantime
+      }
+    } catch ( ... ) {
+      pipe->sampling_error = std::current_exception();
+    }
+    pipe->points.close();
+  }
+
+  void
+  EventStream::materialise( std::vector<Generator*> gens, Pipeline* pipe, std::vector<IntegrandContext*> ctx )
+  {
+    Logger::inherit( pipe->logger );
+    Tracer::get().setThreadName( "materialiser" );
+    try {
+      PointsChunk points;
+      const auto next = [&pipe,&points]() { TraceRegion( "wait for points" ); return pipe->points.pop( points ); };
+      std::vector<double> x;
+      while ( next() && !pipe->stop ) {
+        TraceRegion( "events batch" );
+        Chunk chunk;
+        chunk.events.reserve( points.num_points );
+        //--- the channels may differ in their number of dimensions
+        auto coord = points.coordinates.begin();
+        for ( unsigned int i=0; i<points.num_points && !pipe->stop; i++ ) {
+          const unsigned short chan = ( points.channels.empty() ) ? 0 : points.channels[i];
+          x.assign( coord, coord+gens[chan]->numDimensions() );
+          coord += x.size();
+          chunk.events.emplace_back( gens[chan]->materialise( x, *ctx[chan] ) );
+        }
+        pipe->num_materialised += chunk.events.size();
+        //--- complete the generation state with the materialisation one
+        if ( points.checkpoint ) {
+          if ( points.checkpoint->channels.empty() ) points.checkpoint->process_rng_position = ctx[0]->process->randomGenerator().position();
+          for ( size_t i=0; i<points.checkpoint->channels.size(); i++ ) {
+            points.checkpoint->channels[i].process_rng_position = ctx[i]->process->randomGenerator().position();
+          }
+          chunk.checkpoint = points.checkpoint;
+        }
+        TraceRegion( "wait for a free events slot" );
+        if ( !pipe->events.push( std::move( chunk ) ) ) break; // stream destroyed in the meantime
+      }
+    } catch ( ... ) {
+      pipe->materialisation_error = std::current_exception();
+    }
+    pipe->events.close();
+  }
+
+  std::vector<MetricsExporter::Metric>
+  EventStream::Pipeline::metrics( unsigned long num_events ) const
+  {
+    const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now()-start ).count();
+    const unsigned long sampled = num_sampled, consumed = num_consumed;
+    const unsigned long long trials = num_trials, calls = trials+num_materialised;
+    std::vector<MetricsExporter::Metric> out = {
+      { "cepgen_events_requested", "gauge", "Number of events to be generated", (double)num_events },
+      { "cepgen_events_generated", "counter", "Number of events handed over to the caller", (double)consumed },
+      { "cepgen_points_sampled", "counter", "Number of unweighted phase space points sampled", (double)sampled },
+      { "cepgen_trials_total", "counter", "Number of integrand evaluations for the unweighting", (double)trials },
+      { "cepgen_acceptance_rate", "gauge", "Fraction of the unweighting trials accepted", ( trials > 0 ) ? (double)sampled/trials : 0. },
+      { "cepgen_integrand_calls_total", "counter", "Number of integrand evaluations (unweighting and events materialisation)", (double)calls },
+      { "cepgen_integrand_calls_per_second", "gauge", "Mean rate of integrand evaluations", ( elapsed > 0. ) ? calls/elapsed : 0. },
+      { "cepgen_events_per_second", "gauge", "Mean rate of events generation", ( elapsed > 0. ) ? consumed/elapsed : 0. },
+      { "cepgen_queue_depth", "gauge", "Number of batches waiting in the pipeline queues", (double)points.size(), "queue=\"points\"" },
+      { "cepgen_queue_depth", "gauge", "Number of batches waiting in the pipeline queues", (double)events.size(), "queue=\"events\"" },
+      { "cepgen_elapsed_seconds", "gauge", "Time since the start of the events generation", elapsed }
+    };
+    if ( output_size >= 0 ) out.emplace_back( "cepgen_output_bytes", "gauge", "Size of the output written by the caller", (double)output_size );
+    if ( consumed > 0 ) out.emplace_back( "cepgen_eta_seconds", "gauge", "Estimated time to the completion of the events generation", elapsed/consumed*( num_events-std::min( consumed, num_events ) ) );
+    return out;
+  }
+}
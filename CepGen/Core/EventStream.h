@@ -0,0 +1,200 @@
+#ifndef CepGen_Core_EventStream_h
+#define CepGen_Core_EventStream_h
+
+#include "CepGen/Core/BoundedQueue.h"
+#include "CepGen/Core/Checkpoint.h"
+#include "CepGen/Core/MetricsExporter.h"
+#include "CepGen/Physics/Event.h"
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <functional>
+#include <chrono>
+
+namespace CepGen
+{
+  class Generator;
+  class Cocktail;
+
+  /**
+   * Single-pass range of unweighted events, produced ahead of their consumption
+   * and delivered in batches. Typical usage:
+   * \code
+   * for ( const CepGen::Event& ev : gen.events( 1000 ) ) { ... }
+   * \endcode
+   *
+   * The production is a pipeline of stages running in their own threads, and
+   * connected by bounded queues (a stage waits for the next one to catch up):
+   * - the sampling of unweighted phase space points, with the integrator,
+   * - the materialisation of these points as events (full kinematics), with an
+   *   independent replica of the process,
+   * - the consumption of the events by the caller (e.g. format conversion and
+   *   output), in the caller's thread.
+   *
+   * Lifetime rules:
+   * - the events are copies owned by the stream, hence independent from the
+   *   process' internal event record,
+   * - a reference obtained from an iterator is valid until this iterator is
+   *   incremented, or until the stream is destroyed,
+   * - while the stream is alive, the Generator object is exclusively used by
+   *   the production threads, and must not be accessed by the caller.
+   *
+   * If checkpoints are requested in the generation parameters, the generation
+   * state is written once all events preceding the checkpoint were handed over
+   * to (and processed by) the caller, i.e. when the iterator moves past them.
+   *
+   * If a metrics file is set in the generation parameters, the progress and
+   * throughput of the production are periodically exported into it (see
+   * MetricsExporter) while the stream is iterated.
+   *
+   * The events of a cocktail run are produced the same way, each point being
+   * sampled in a channel picked according to its cross section, then
+   * materialised with a replica of this channel's process.
+   * \date Oct 2026
+   */
+  class EventStream
+  {
+    public:
+      /// Collection of events produced in one go
+      typedef std::vector<Event> Batch;
+
+      /// Input iterator over the produced events
+      class iterator
+      {
+        public:
+          typedef std::input_iterator_tag iterator_category;
+          typedef Event value_type;
+          typedef std::ptrdiff_t difference_type;
+          typedef const Event* pointer;
+          typedef const Event& reference;
+
+          iterator( EventStream* stream=nullptr ) : stream_( stream ) {}
+          reference operator*() const { return stream_->current(); }
+          pointer operator->() const { return &stream_->current(); }
+          iterator& operator++() {
+            if ( !stream_->next() ) stream_ = nullptr;
+            return *this;
+          }
+          bool operator==( const iterator& rhs ) const { return stream_ == rhs.stream_; }
+          bool operator!=( const iterator& rhs ) const { return stream_ != rhs.stream_; }
+
+        private:
+          EventStream* stream_;
+      };
+
+      /// Book a stream of events
+      /// \note Streams are to be obtained from Generator::events, which prepares the process beforehand
+      /// \param[in] gen Generator to be used for the production
+      /// \param[in] num_events Number of events to deliver
+      /// \param[in] batch_size Number of events produced and handed over in one go
+      /// \param[in] num_batches Maximal number of batches produced ahead of their consumption
+      EventStream( Generator& gen, unsigned long num_events, unsigned int batch_size=100, unsigned int num_batches=4 );
+      /// Book a stream of events mixing all channels of a cocktail
+      /// \note Streams are to be obtained from Cocktail::events, which computes the channels cross sections beforehand
+      EventStream( Cocktail& cocktail, unsigned long num_events, unsigned int batch_size=100, unsigned int num_batches=4 );
+      EventStream( EventStream&& ) = default;
+      EventStream( const EventStream& ) = delete;
+      EventStream& operator=( const EventStream& ) = delete;
+      /// Stop the production (if still running) and release all events
+      ~EventStream();
+
+      /// Start the production, and point to the first event delivered
+      iterator begin();
+      /// Past-the-end marker
+      iterator end() { return iterator(); }
+
+      /// Number of events already handed over to the caller
+      unsigned long numConsumed() const { return num_consumed_; }
+      /// Set the function to be called before each checkpoint is written, e.g. to
+      /// flush the caller's output, and retrieve its current size (in bytes)
+      void onCheckpoint( std::function<long long()> sync ) { sync_ = sync; }
+      /// Set the function retrieving the current size of the caller's output (in bytes),
+      /// polled in the caller's thread at each new batch, for the metrics export
+      void onBatch( std::function<long long()> output_size ) { output_size_ = output_size; }
+
+    private:
+      /// Batch of phase space points, along with the generation state after its last point (if checkpointed)
+      struct PointsChunk
+      {
+        PointsChunk() : num_points( 0 ) {}
+        /// Coordinates of all points, one after the other
+        std::vector<double> coordinates;
+        /// Channel of each point (cocktail runs only)
+        std::vector<unsigned short> channels;
+        unsigned int num_points;
+        std::shared_ptr<Checkpoint> checkpoint;
+      };
+      /// Batch of events, along with the generation state after its last event (if checkpointed)
+      struct Chunk
+      {
+        Batch events;
+        std::shared_ptr<Checkpoint> checkpoint;
+      };
+      /// State shared between the pipeline stages
+      struct Pipeline
+      {
+        Pipeline( unsigned int num_batches ) :
+          points( num_batches ), events( num_batches ), stop( false ), logger( Logger::get() ),
+          num_sampled( 0 ), num_trials( 0 ), num_materialised( 0 ), num_consumed( 0 ), output_size( -1 ),
+          start( std::chrono::steady_clock::now() ) {}
+        /// Metrics of the production, as collected by the metrics exporter
+        std::vector<MetricsExporter::Metric> metrics( unsigned long num_events ) const;
+        BoundedQueue<PointsChunk> points;
+        BoundedQueue<Chunk> events;
+        std::atomic<bool> stop;
+        /// Logger of the thread which booked the stream, for both stages to inherit
+        const Logger logger;
+        /// Failures in the sampling and materialisation stages
+        std::exception_ptr sampling_error, materialisation_error;
+        /// Number of points sampled, and of integrand evaluations needed for their unweighting
+        std::atomic<unsigned long> num_sampled;
+        std::atomic<unsigned long long> num_trials;
+        /// Number of events materialised, and handed over to the caller
+        std::atomic<unsigned long> num_materialised, num_consumed;
+        /// Size of the caller's output, in bytes (-1 if unknown)
+        std::atomic<long long> output_size;
+        /// Start of the production
+        const std::chrono::steady_clock::time_point start;
+      };
+      EventStream( const std::vector<Generator*>& gens, Cocktail* cocktail, unsigned long num_events, unsigned int batch_size, unsigned int num_batches );
+      /// Sampling stage, running in its own thread
+      static void sample( std::vector<Generator*> gens, Cocktail* cocktail, Pipeline* pipe, unsigned long num_events, unsigned int batch_size, unsigned int checkpoint_every );
+      /// Materialisation stage, running in its own thread
+      static void materialise( std::vector<Generator*> gens, Pipeline* pipe, std::vector<IntegrandContext*> ctx );
+      /// Move to the next event, fetching a new batch if needed
+      /// \return false if the stream is exhausted
+      bool next();
+      /// Retrieve a new batch from the production thread
+      bool fetch();
+      const Event& current() const { return chunk_.events[pos_]; }
+
+      /// Generators of all channels (a single one outside cocktail runs)
+      std::vector<Generator*> gens_;
+      /// Cocktail the channels belong to (if any)
+      Cocktail* cocktail_;
+      unsigned long num_events_;
+      unsigned int batch_size_;
+      unsigned int checkpoint_every_;
+      std::string checkpoint_file_;
+      std::function<long long()> sync_, output_size_;
+      std::string metrics_file_;
+      double metrics_period_;
+      std::unique_ptr<Pipeline> pipeline_;
+      /// Evaluation contexts (and process replicas) used for the materialisation of the events, one per channel
+      std::vector<std::unique_ptr<IntegrandContext> > replicas_;
+      std::thread sampler_, materialiser_;
+      /// Periodic export of the production metrics (if requested)
+      std::unique_ptr<MetricsExporter> metrics_;
+      /// Batch being consumed
+      Chunk chunk_;
+      /// Position of the current event in the batch being consumed
+      size_t pos_;
+      unsigned long num_consumed_;
+  };
+}
+
+#endif
@@ -14,6 +14,7 @@ using std::string;
 namespace CepGen
 {
   /// \brief A string-to-functional parser
+  /// \note The evaluation alters the variables bound to the parser, hence each thread is to use its own copy
   /// \tparam N Number of arguments
   /// \author L. Forthomme <laurent.forthomme@cern.ch>
   /// \date 21 Aug 2017
@@ -24,17 +25,29 @@ namespace CepGen
       /// Default constructor
       Functional() {}
       /// Copy constructor
-      Functional( const Functional& rhs )
+      Functional( const Functional& rhs ) : vars_( rhs.vars_ ), expression_( rhs.expression_ ) {
 #ifdef MUPARSER
-        : values_( rhs.values_ ), vars_( rhs.vars_ ), expression_( rhs.expression_ ) {
-          for ( unsigned short i = 0; i < vars_.size(); ++i ) {
+        values_ = rhs.values_;
+        for ( unsigned short i = 0; i < vars_.size(); ++i ) {
           parser_.DefineVar( vars_[i], &values_[i] );
         }
         parser_.SetExpr( expression_ );
+#endif
       }
-#else
-      {}
+      /// Assignment operator (the parser is bound to the variables of this object)
+      Functional& operator=( const Functional& rhs ) {
+        vars_ = rhs.vars_;
+        expression_ = rhs.expression_;
+#ifdef MUPARSER
+        values_ = rhs.values_;
+        parser_.ClearVar();
+        for ( unsigned short i = 0; i < vars_.size(); ++i ) {
+          parser_.DefineVar( vars_[i], &values_[i] );
+        }
+        parser_.SetExpr( expression_ );
 #endif
+        return *this;
+      }
       /// Build a parser from an expression and a variables list
       /// \param[in] expr Expression to parse
       /// \param[in] vars List of variables to parse
@@ -1,19 +1,52 @@
 #include "CepGen/Generator.h"
 #include "CepGen/Version.h"
+#include "CepGen/Cards/ConfigReader.h"
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace CepGen
 {
+  namespace
+  {
+    /// Configuration card in the temporary files directory ($TMPDIR, or /tmp), removed when going out of scope
+    struct TemporaryCard
+    {
+      TemporaryCard() {
+        const char* dir = getenv( "TMPDIR" );
+        path = std::string( ( dir && *dir ) ? dir : "/tmp" )+"/cepgen_cardXXXXXX";
+        fd = mkstemp( &path[0] );
+        if ( fd < 0 ) {
+          throw Exception( __PRETTY_FUNCTION__, Form( "Failed to create a temporary configuration card \"%s\"", path.c_str() ), FatalError );
+        }
+      }
+      ~TemporaryCard() {
+        if ( fd >= 0 ) close( fd );
+        remove( path.c_str() );
+      }
+      std::string path;
+      int fd;
+    };
+  }
+
   Generator::Generator() :
-    cross_section_( -1. ), cross_section_error_( -1. ), has_cross_section_( false )
+    cross_section_( -1. ), cross_section_error_( -1. ), has_cross_section_( false ), integration_restored_( false )
   {
     Debugging( "Generator initialized" );
     try { printHeader(); } catch ( Exception& e ) { e.dump(); }
-    srand( time( 0 ) ); // Random number initialization
     this->parameters = std::unique_ptr<Parameters>( new Parameters );
   }
 
   Generator::Generator( Parameters* ip ) :
-    parameters( ip )
+    parameters( ip ),
+    cross_section_( -1. ), cross_section_error_( -1. ), has_cross_section_( false ), integration_restored_( false )
   {}
 
   Generator::~Generator()
@@ -21,12 +54,16 @@ namespace CepGen
     if ( parameters->generation.enabled && parameters->process() && parameters->process()->numGeneratedEvents()>0 ) {
       Information( Form( "Mean generation time / event: %.3f ms", parameters->process()->totalGenerationTime()*1.e3/parameters->process()->numGeneratedEvents() ) );
     }
+    //--- nothing to report for a generator which never ran (e.g. holding the parameters of a cocktail)
+    if ( !parameters->report_file.empty() && vegas_ ) {
+      try { report().write( parameters->report_file ); } catch ( Exception& e ) { e.dump(); }
+    }
   }
 
   void
   Generator::clearRun()
   {
-    parameters->vegas.first_run = true;
+    if ( context_ ) context_->prepared = false;
     has_cross_section_ = false; // force the recreation of the Vegas instance
     cross_section_ = cross_section_error_ = -1.;
   }
@@ -56,12 +93,19 @@ namespace CepGen
   void
   Generator::computeXsection( double& xsec, double& err )
   {
+    try { prepareFunction(); } catch ( Exception& e ) { e.dump(); }
+
     // first destroy and recreate the Vegas instance
     if ( !vegas_ ) {
-      vegas_ = std::unique_ptr<Vegas>( new Vegas( numDimensions(), f, parameters.get() ) );
+      vegas_ = std::unique_ptr<Vegas>( new Vegas( numDimensions(), f, parameters.get(), context_.get() ) );
     }
     else if ( vegas_->dimensions() != numDimensions() ) {
-      vegas_.reset( new Vegas( numDimensions(), f, parameters.get() ) );
+      vegas_.reset( new Vegas( numDimensions(), f, parameters.get(), context_.get() ) );
+    }
+    const bool warm_start = ( start_grid_.bins > 0 );
+    if ( warm_start ) {
+      vegas_->setGrid( start_grid_ );
+      start_grid_ = Vegas::Grid();
     }
 
     if ( Logger::get().level>=Logger::Debug ) {
@@ -73,14 +117,42 @@ namespace CepGen
 
     Information( "Starting the computation of the process cross-section" );
 
-    try { prepareFunction(); } catch ( Exception& e ) { e.dump(); }
-
-    has_cross_section_ = ( vegas_->integrate( cross_section_, cross_section_error_ ) == 0 );
+    //--- the cache holds no differential cross sections, hence is not used to retrieve the results if some are requested
+    const std::string& cache_dir = parameters->vegas.cache_directory;
+    if ( cache_dir.empty() || !parameters->histograms.empty() || !retrieveIntegration( IntegrationCache( cache_dir ) ) ) {
+      integration_restored_ = false;
+      has_cross_section_ = ( vegas_->integrate( cross_section_, cross_section_error_ ) == 0 );
+      //--- a result depending on the starting grid is not stored under the integrand's description
+      if ( has_cross_section_ && !cache_dir.empty() && !warm_start ) storeIntegration( IntegrationCache( cache_dir ) );
+    }
 
     xsec = cross_section_;
     err = cross_section_error_;
 
     Information( Form( "Total cross section: %f +/- %f pb", xsec, err ) );
+    for ( const auto& hist : vegas_->histograms() ) {
+      std::ostringstream os; hist.dump( os );
+      Information( os.str() );
+    }
+    Profiler::get().summary( "integration" );
+  }
+
+  const Vegas::Grid&
+  Generator::integrationGrid() const
+  {
+    if ( !vegas_ ) {
+      throw Exception( __PRETTY_FUNCTION__, "No integration performed yet!", FatalError );
+    }
+    return vegas_->grid();
+  }
+
+  const std::vector<Histogram>&
+  Generator::histograms() const
+  {
+    if ( !vegas_ ) {
+      throw Exception( __PRETTY_FUNCTION__, "No integration performed yet!", FatalError );
+    }
+    return vegas_->histograms();
   }
 
   Event*
@@ -96,6 +168,283 @@ namespace CepGen
     return last_event.get();
   }
 
+  EventStream
+  Generator::events( unsigned long num_events, unsigned int batch_size )
+  {
+    //--- integrate beforehand so that the production thread only deals with the unweighting
+    if ( !has_cross_section_ ) {
+      computeXsection( cross_section_, cross_section_error_ );
+    }
+    return EventStream( *this, num_events, batch_size );
+  }
+
+  void
+  Generator::samplePoint( std::vector<double>& x )
+  {
+    if ( !has_cross_section_ ) {
+      computeXsection( cross_section_, cross_section_error_ );
+    }
+    x.resize( numDimensions() );
+    while ( !vegas_->sample( x ) ) {}
+    parameters->generation.ngen += 1;
+  }
+
+  std::unique_ptr<IntegrandContext>
+  Generator::replicaContext() const
+  {
+    return context_->clone();
+  }
+
+  const Event&
+  Generator::materialise( const std::vector<double>& x, IntegrandContext& ctx )
+  {
+    vegas_->materialise( x, &ctx );
+    return *ctx.process->event();
+  }
+
+  std::vector<double>
+  Generator::computePoints( const double* x, size_t num_points, unsigned short num_threads )
+  {
+    if ( !context_ || !context_->prepared ) prepareFunction();
+    const size_t ndim = numDimensions();
+    std::vector<double> weights( num_points, 0. );
+
+    if ( num_threads == 0 ) num_threads = std::max( std::thread::hardware_concurrency(), 1u );
+    num_threads = std::min<size_t>( num_threads, std::max<size_t>( num_points/block_size_, 1 ) );
+
+    //--- each thread picks the next block of points not yet computed
+    std::atomic<size_t> next_block( 0 );
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<IntegrandContext> > contexts;
+    for ( unsigned short i=0; i<num_threads; i++ ) contexts.emplace_back( context_->clone() );
+    const Logger& logger = Logger::get();
+    for ( unsigned short i=0; i<num_threads; i++ ) {
+      IntegrandContext* ctx = contexts[i].get();
+      threads.emplace_back( [&, ctx]() {
+        Logger::inherit( logger );
+        Tracer::get().setThreadName( "points worker" );
+        try {
+          for ( size_t beg=( next_block++ )*block_size_; beg<num_points; beg=( next_block++ )*block_size_ ) {
+            TraceRegion( "points block" );
+            const size_t end = std::min( beg+block_size_, num_points );
+            for ( size_t j=beg; j<end; j++ ) weights[j] = f( const_cast<double*>( x+j*ndim ), ndim, ctx );
+          }
+        } catch ( ... ) {
+          std::lock_guard<std::mutex> lock( error_mutex );
+          if ( !error ) error = std::current_exception();
+          next_block = num_points; // stop all threads
+        }
+      } );
+    }
+    for ( auto& thr : threads ) thr.join();
+    if ( error ) std::rethrow_exception( error );
+
+    Debugging( Form( "%zu points computed in %d thread(s)", num_points, num_threads ) );
+    return weights;
+  }
+
+  std::vector<double>
+  Generator::computePoints( const std::string& file, unsigned short num_threads )
+  {
+    const size_t point_size = numDimensions()*sizeof( double );
+    const int fd = open( file.c_str(), O_RDONLY );
+    struct stat st;
+    if ( fd < 0 || fstat( fd, &st ) != 0 ) {
+      if ( fd >= 0 ) close( fd );
+      throw Exception( __PRETTY_FUNCTION__, Form( "Failed to open the points file \"%s\"", file.c_str() ), JustWarning );
+    }
+    if ( point_size == 0 || st.st_size % point_size != 0 ) {
+      close( fd );
+      throw Exception( __PRETTY_FUNCTION__, Form( "Size of the points file \"%s\" (%lld bytes) is not a multiple of the size of a %zu-dimensional point", file.c_str(), (long long)st.st_size, numDimensions() ), JustWarning );
+    }
+    const size_t num_points = st.st_size/point_size;
+    if ( num_points == 0 ) { close( fd ); return std::vector<double>(); }
+
+    void* data = mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd ); // the mapping remains valid
+    if ( data == MAP_FAILED ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Failed to map the points file \"%s\" in memory", file.c_str() ), JustWarning );
+    }
+    madvise( data, st.st_size, MADV_SEQUENTIAL );
+    std::vector<double> weights;
+    try { weights = computePoints( static_cast<const double*>( data ), num_points, num_threads ); } catch ( ... ) {
+      munmap( data, st.st_size );
+      throw;
+    }
+    munmap( data, st.st_size );
+    return weights;
+  }
+
+  Checkpoint
+  Generator::checkpoint()
+  {
+    if ( !has_cross_section_ ) {
+      computeXsection( cross_section_, cross_section_error_ );
+    }
+    Checkpoint out;
+    out.seed = parameters->vegas.seed;
+    out.stream = parameters->vegas.stream;
+    out.num_dimensions = numDimensions();
+    out.cross_section = cross_section_;
+    out.cross_section_error = cross_section_error_;
+    out.vegas = vegas_->generationState();
+    out.ngen = parameters->generation.ngen;
+    out.process_rng_position = parameters->process()->randomGenerator().position();
+    return out;
+  }
+
+  Checkpoint
+  Generator::resume( const std::string& file )
+  {
+    const Checkpoint ckpt = Checkpoint::load( file );
+    resume( ckpt );
+    Information( Form( "Run resumed from checkpoint \"%s\" after %d events\n\t"
+                       "Total cross section: %f +/- %f pb", file.c_str(), ckpt.ngen, cross_section_, cross_section_error_ ) );
+    return ckpt;
+  }
+
+  void
+  Generator::resume( const Checkpoint& ckpt )
+  {
+    if ( ckpt.seed != parameters->vegas.seed || ckpt.stream != parameters->vegas.stream || ckpt.num_dimensions != numDimensions() ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Checkpoint (seed %llu, stream %llu, %d dimensions) does not match the run (seed %llu, stream %llu, %d dimensions)!", ckpt.seed, ckpt.stream, ckpt.num_dimensions, parameters->vegas.seed, parameters->vegas.stream, numDimensions() ), FatalError );
+    }
+    prepareFunction();
+    if ( !vegas_ || vegas_->dimensions() != numDimensions() ) {
+      vegas_.reset( new Vegas( numDimensions(), f, parameters.get(), context_.get() ) );
+    }
+    vegas_->restoreGenerationState( ckpt.vegas );
+    parameters->process()->randomGenerator().seek( ckpt.process_rng_position );
+    parameters->generation.ngen = ckpt.ngen;
+
+    cross_section_ = ckpt.cross_section;
+    cross_section_error_ = ckpt.cross_section_error;
+    has_cross_section_ = true;
+    integration_restored_ = true;
+  }
+
+  bool
+  Generator::retrieveIntegration( const IntegrationCache& cache )
+  {
+    IntegrationCache::Entry entry;
+    if ( !cache.load( *parameters, entry ) || entry.state.num_dimensions != numDimensions() ) return false;
+    restoreIntegration( entry );
+    Information( Form( "Integration results retrieved from cache \"%s\"", cache.file( *parameters ).c_str() ) );
+    //--- complete the entry with the generation grid, prepared here once for all
+    if ( parameters->generation.enabled && !entry.has_generation_state ) storeIntegration( cache );
+    return true;
+  }
+
+  void
+  Generator::storeIntegration( const IntegrationCache& cache )
+  {
+    try { cache.store( *parameters, integrationEntry( parameters->generation.enabled ) ); } catch ( Exception& e ) { e.dump(); }
+  }
+
+  IntegrationCache::Entry
+  Generator::integrationEntry( bool with_generation_state )
+  {
+    IntegrationCache::Entry entry;
+    entry.has_generation_state = with_generation_state;
+    if ( entry.has_generation_state ) entry.state = checkpoint(); // prepares the generation grid
+    else {
+      entry.state.seed = parameters->vegas.seed;
+      entry.state.stream = parameters->vegas.stream;
+      entry.state.num_dimensions = numDimensions();
+      entry.state.cross_section = cross_section_;
+      entry.state.cross_section_error = cross_section_error_;
+      entry.state.vegas.rng_position = vegas_->randomGenerator().position();
+      entry.state.process_rng_position = parameters->process()->randomGenerator().position();
+    }
+    entry.grid = vegas_->grid();
+    return entry;
+  }
+
+  void
+  Generator::restoreIntegration( const IntegrationCache::Entry& entry )
+  {
+    vegas_->restoreGrid( entry.grid );
+    if ( entry.has_generation_state ) vegas_->restoreGenerationState( entry.state.vegas );
+    else vegas_->randomGenerator().seek( entry.state.vegas.rng_position );
+    parameters->process()->randomGenerator().seek( entry.state.process_rng_position );
+
+    cross_section_ = entry.state.cross_section;
+    cross_section_error_ = entry.state.cross_section_error;
+    has_cross_section_ = true;
+    integration_restored_ = true;
+  }
+
+  Gridpack
+  Generator::gridpack()
+  {
+    Gridpack out;
+    out.entry = integrationEntry( true );
+    out.description = IntegrationCache::description( *parameters );
+    //--- full run parameters, through a temporary configuration card
+    {
+      const TemporaryCard card_file;
+      Cards::ConfigReader::store( parameters.get(), card_file.path.c_str() );
+      std::ifstream card( card_file.path );
+      out.card.assign( std::istreambuf_iterator<char>( card ), std::istreambuf_iterator<char>() );
+    }
+    if ( out.card.empty() ) InWarning( "The run parameters could not be stored in the gridpack; they will have to be set by the generation jobs" );
+    return out;
+  }
+
+  void
+  Generator::loadGridpack( const Gridpack& gp, unsigned long long seed )
+  {
+    if ( !gp.card.empty() ) {
+      const TemporaryCard card_file;
+      if ( write( card_file.fd, gp.card.c_str(), gp.card.size() ) != (ssize_t)gp.card.size() ) {
+        throw Exception( __PRETTY_FUNCTION__, Form( "Failed to write the temporary configuration card \"%s\"", card_file.path.c_str() ), FatalError );
+      }
+      setParameters( Cards::ConfigReader( card_file.path.c_str() ).parameters() );
+    }
+    if ( !parameters->process() || IntegrationCache::description( *parameters ) != gp.description ) {
+      throw Exception( __PRETTY_FUNCTION__, "The gridpack was prepared for other run parameters!", FatalError );
+    }
+    //--- the prepared random sequences are only kept if the seed is unchanged
+    IntegrationCache::Entry entry = gp.entry;
+    if ( seed != parameters->vegas.seed ) {
+      parameters->vegas.seed = seed;
+      entry.state.vegas.rng_position = entry.state.process_rng_position = 0;
+    }
+    parameters->generation.enabled = true;
+    parameters->generation.ngen = 0;
+    prepareFunction();
+    vegas_.reset( new Vegas( numDimensions(), f, parameters.get(), context_.get() ) );
+    restoreIntegration( entry );
+
+    Information( Form( "Run prepared from gridpack with seed %llu\n\t"
+                       "Total cross section: %f +/- %f pb", seed, cross_section_, cross_section_error_ ) );
+  }
+
+  RunReport
+  Generator::report()
+  {
+    RunReport out;
+    if ( parameters->process() ) {
+      out.configuration_hash = IntegrationCache::hash( IntegrationCache::description( *parameters ) );
+      out.process = parameters->processName();
+      out.num_dimensions = numDimensions();
+      out.events_time = parameters->process()->totalGenerationTime();
+    }
+    out.seed = parameters->vegas.seed;
+    out.cross_section = cross_section_;
+    out.cross_section_error = cross_section_error_;
+    out.integration_restored = integration_restored_;
+    if ( vegas_ ) out.vegas = vegas_->statistics();
+    out.num_events = parameters->generation.ngen;
+    out.num_function_calls = numFunctionCalls();
+    out.wall_time = run_timer_.elapsed();
+    struct rusage usage;
+    if ( getrusage( RUSAGE_SELF, &usage ) == 0 ) out.peak_memory = usage.ru_maxrss;
+    return out;
+  }
+
   void
   Generator::prepareFunction()
   {
@@ -105,6 +454,19 @@ namespace CepGen
     Kinematics kin = parameters->kinematics;
     parameters->process()->addEventContent();
     parameters->process()->setKinematics( kin );
+    //--- give the process its own random numbers sequence, independent from the integrator's one
+    parameters->process()->setRandomGenerator( RandomGenerator( parameters->vegas.seed, parameters->vegas.stream+1 ) );
+    //--- (re)bind the default evaluation context to the run parameters
+    if ( !context_ ) context_.reset( new IntegrandContext( parameters.get(), parameters->process() ) );
+    context_->parameters = parameters.get();
+    context_->process = parameters->process();
+    context_->taming_functions = parameters->taming_functions;
+    context_->prepared = false;
+    //--- timeline of the run, recorded from now on (unless an enclosing run records it already)
+    if ( !parameters->trace_file.empty() && !trace_session_ ) {
+      trace_session_.reset( new Tracer::Session( parameters->trace_file, parameters->trace_capacity ) );
+      if ( trace_session_->recording() ) Tracer::get().setThreadName( "generator" );
+    }
     Debugging( "Function prepared to be integrated!" );
   }
 }
@@ -0,0 +1,60 @@
+#include "CepGen/Core/Gridpack.h"
+
+namespace CepGen
+{
+  namespace
+  {
+    /// Version of the gridpack files layout
+    constexpr unsigned short kGridpackVersion = 1;
+  }
+
+  void
+  Gridpack::save( const std::string& file ) const
+  {
+    const bool written = writeAtomically( file, [this]( std::ostream& out ) {
+      out
+        << "cepgen_gridpack " << kGridpackVersion << "\n"
+        << "card " << card.size() << "\n" << card << "\n"
+        << "description " << description << "\n";
+      entry.write( out );
+    } );
+    if ( !written ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Failed to write gridpack \"%s\"", file.c_str() ), FatalError );
+    }
+    Information( Form( "Gridpack written in \"%s\"", file.c_str() ) );
+  }
+
+  Gridpack
+  Gridpack::load( const std::string& file )
+  {
+    std::ifstream in( file );
+    if ( !in.is_open() ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Failed to open gridpack \"%s\"", file.c_str() ), FatalError );
+    }
+    Gridpack out;
+    std::string key;
+    unsigned short version = 0;
+    if ( !( in >> key >> version ) || key != "cepgen_gridpack" || version != kGridpackVersion ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Unsupported gridpack \"%s\"", file.c_str() ), FatalError );
+    }
+    size_t card_size = 0;
+    in >> key >> card_size;
+    in.get(); // end of line
+    out.card.resize( card_size );
+    if ( key != "card" || !in.read( &out.card[0], card_size ) ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Corrupted gridpack \"%s\"", file.c_str() ), FatalError );
+    }
+    in >> key >> std::ws;
+    std::getline( in, out.description );
+    if ( key != "description" ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Corrupted gridpack \"%s\"", file.c_str() ), FatalError );
+    }
+    try { out.entry = IntegrationCache::Entry::read( in, file ); } catch ( Exception& e ) {
+      throw Exception( __PRETTY_FUNCTION__, e.what(), FatalError );
+    }
+    if ( !out.entry.has_generation_state ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Gridpack \"%s\" holds no generation grid", file.c_str() ), FatalError );
+    }
+    return out;
+  }
+}
@@ -0,0 +1,33 @@
+#ifndef CepGen_Core_Gridpack_h
+#define CepGen_Core_Gridpack_h
+
+#include "CepGen/Core/IntegrationCache.h"
+
+#include <string>
+
+namespace CepGen
+{
+  /**
+   * Self-contained snapshot of a prepared run: the full run parameters, the
+   * integration results and the generation grid. Produced once, it lets any
+   * number of jobs generate events right away, each with its own seed.
+   * \date Oct 2026
+   */
+  struct Gridpack
+  {
+    /// Write the gridpack into a file
+    /// \note The file is written under a temporary name, then renamed
+    void save( const std::string& file ) const;
+    /// Read a gridpack from a file
+    static Gridpack load( const std::string& file );
+
+    /// Run parameters, as a configuration card (empty if the cards cannot be written)
+    std::string card;
+    /// Canonical description of the integrand prepared (see IntegrationCache::description)
+    std::string description;
+    /// Integration results and generation grid
+    IntegrationCache::Entry entry;
+  };
+}
+
+#endif
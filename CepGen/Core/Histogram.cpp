@@ -0,0 +1,106 @@
+#include "CepGen/Core/Histogram.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace CepGen
+{
+  Histogram::Histogram( const std::string& variable, unsigned int num_bins, double min, double max ) :
+    variable_( variable ), min_( min ), max_( max ),
+    sum_( num_bins, 0. ), sum2_( num_bins, 0. ), wgt_value_( num_bins, 0. ), wgt_var_( num_bins, 0. ),
+    sum_weights_( 0. )
+  {
+    if ( variable != "m_central" && variable != "pt_central" && variable != "y_central"
+      && variable != "pt_single" && variable != "eta_single" && variable != "mx" && variable != "my" ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Invalid observable \"%s\" for a histogram!", variable.c_str() ), FatalError );
+    }
+    if ( num_bins == 0 || max <= min ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Invalid binning for the \"%s\" histogram: %d bins in [%g, %g]", variable.c_str(), num_bins, min, max ), FatalError );
+    }
+  }
+
+  void
+  Histogram::fill( Event& ev, double weight )
+  {
+    if ( variable_ == "pt_single" || variable_ == "eta_single" ) {
+      for ( const auto& role : { Particle::CentralParticle1, Particle::CentralParticle2 } ) {
+        const Particle::Momentum& mom = ev.getOneByRole( role ).momentum();
+        add( ( variable_ == "pt_single" ) ? mom.pt() : mom.eta(), weight );
+      }
+      return;
+    }
+    if ( variable_ == "mx" ) return add( ev.getOneByRole( Particle::OutgoingBeam1 ).momentum().mass(), weight );
+    if ( variable_ == "my" ) return add( ev.getOneByRole( Particle::OutgoingBeam2 ).momentum().mass(), weight );
+
+    const Particle::Momentum central_system( ev.getOneByRole( Particle::CentralParticle1 ).momentum() + ev.getOneByRole( Particle::CentralParticle2 ).momentum() );
+    if ( variable_ == "m_central" ) add( central_system.mass(), weight );
+    else if ( variable_ == "pt_central" ) add( central_system.pt(), weight );
+    else add( central_system.rapidity(), weight );
+  }
+
+  void
+  Histogram::add( double val, double weight )
+  {
+    if ( val < min_ || val >= max_ ) return;
+    const unsigned int bin = ( val-min_ )/( max_-min_ )*numBins();
+    if ( bin >= numBins() ) return;
+    sum_[bin] += weight;
+    sum2_[bin] += weight*weight;
+  }
+
+  void
+  Histogram::endIteration( unsigned long num_calls, double weight )
+  {
+    if ( num_calls > 1 ) {
+      const double inv_calls = 1./num_calls;
+      for ( unsigned int i=0; i<numBins(); i++ ) {
+        const double val = sum_[i]*inv_calls, var = ( sum2_[i]*inv_calls-val*val )/( num_calls-1 );
+        wgt_value_[i] += weight*val;
+        wgt_var_[i] += weight*weight*std::max( var, 0. );
+      }
+      sum_weights_ += weight;
+    }
+    std::fill( sum_.begin(), sum_.end(), 0. );
+    std::fill( sum2_.begin(), sum2_.end(), 0. );
+  }
+
+  void
+  Histogram::reset()
+  {
+    for ( auto* vec : { &sum_, &sum2_, &wgt_value_, &wgt_var_ } ) std::fill( vec->begin(), vec->end(), 0. );
+    sum_weights_ = 0.;
+  }
+
+  double
+  Histogram::value( unsigned int bin ) const
+  {
+    if ( bin >= numBins() || sum_weights_ <= 0. ) return 0.;
+    return wgt_value_[bin]/sum_weights_;
+  }
+
+  double
+  Histogram::error( unsigned int bin ) const
+  {
+    if ( bin >= numBins() || sum_weights_ <= 0. ) return 0.;
+    return sqrt( wgt_var_[bin] )/sum_weights_;
+  }
+
+  double
+  Histogram::integral() const
+  {
+    double out = 0.;
+    for ( unsigned int i=0; i<numBins(); i++ ) out += value( i );
+    return out;
+  }
+
+  void
+  Histogram::dump( std::ostream& os ) const
+  {
+    std::ostringstream oss;
+    oss << Form( "Differential cross section in %s (%d bins, integral: %g pb):\n", variable_.c_str(), numBins(), integral() );
+    for ( unsigned int i=0; i<numBins(); i++ ) {
+      oss << Form( "  [%10.4g, %10.4g[  %12.5e +/- %10.3e pb\n", binLow( i ), binHigh( i ), value( i ), error( i ) );
+    }
+    os << oss.str();
+  }
+}
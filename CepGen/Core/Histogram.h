@@ -0,0 +1,77 @@
+#ifndef CepGen_Core_Histogram_h
+#define CepGen_Core_Histogram_h
+
+#include "CepGen/Physics/Event.h"
+
+#include <string>
+#include <vector>
+
+namespace CepGen
+{
+  /**
+   * Differential cross section in one observable, filled with the weights of the
+   * integrand during the integration iterations, hence without any events
+   * generation. Each iteration provides an independent estimate of the bins
+   * contents; as for the cross section, the estimates are combined with weights
+   * given by the inverse of the variance of each iteration's integral.
+   * \date Oct 2026
+   */
+  class Histogram
+  {
+    public:
+      /**
+       * Book a histogram for one observable
+       * \param[in] variable Name of the observable: m_central, pt_central, y_central (central system mass,
+       *  transverse momentum, rapidity), pt_single, eta_single (filled once for each central particle), mx, my
+       *  (outgoing remnants masses)
+       * \param[in] num_bins Number of bins
+       * \param[in] min Lower edge of the first bin
+       * \param[in] max Upper edge of the last bin
+       */
+      Histogram( const std::string& variable, unsigned int num_bins, double min, double max );
+
+      /// Add a phase space point to the current iteration
+      /// \param[in] ev Event, with its full kinematics computed
+      /// \param[in] weight Integrand value times the inverse of the sampling density at this point
+      void fill( Event& ev, double weight );
+      /**
+       * Close the current iteration, and add its estimate of the bins contents to the combination
+       * \param[in] num_calls Number of points sampled during the iteration (including the ones not filled)
+       * \param[in] weight Weight of the iteration (inverse of the variance of its integral estimate)
+       */
+      void endIteration( unsigned long num_calls, double weight );
+      /// Clear the contents of all iterations
+      void reset();
+
+      /// Name of the observable
+      const std::string& variable() const { return variable_; }
+      /// Number of bins
+      unsigned int numBins() const { return sum_.size(); }
+      /// Lower edge of a bin
+      double binLow( unsigned int bin ) const { return min_+bin*( max_-min_ )/numBins(); }
+      /// Upper edge of a bin
+      double binHigh( unsigned int bin ) const { return binLow( bin+1 ); }
+      /// Cross section in a bin, in pb (not divided by the bin width)
+      double value( unsigned int bin ) const;
+      /// Error on the cross section in a bin, in pb
+      double error( unsigned int bin ) const;
+      /// Cross section in the histogram range, in pb
+      double integral() const;
+      /// Print the bins contents
+      void dump( std::ostream& os=Logger::get().outputStream ) const;
+
+    private:
+      void add( double val, double weight );
+
+      std::string variable_;
+      double min_, max_;
+      /// Sum of the weights (and of their squares) in each bin, for the current iteration
+      std::vector<double> sum_, sum2_;
+      /// Weighted sum of the iterations estimates (and of their variances) in each bin
+      std::vector<double> wgt_value_, wgt_var_;
+      /// Sum of the iterations weights
+      double sum_weights_;
+  };
+}
+
+#endif
@@ -2,26 +2,27 @@
 
 namespace CepGen
 {
-  double
-  f( double* x, size_t ndim, void* params )
+  namespace
   {
-    std::ostringstream os;
+    /// Reset the process' event before an evaluation (and prepare it at the first one)
+    void
+    prepareEvent( IntegrandContext* ctx )
+    {
+      const Parameters* p = ctx->parameters;
+      Process::GenericProcess* proc = ctx->process;
+      std::shared_ptr<Event> ev = proc->event();
 
-    Parameters* p = static_cast<Parameters*>( params );
-    std::shared_ptr<Event> ev = p->process()->event();
-
-    if ( p->process()->hasEvent() ) {
-      p->process()->clearEvent();
+      proc->clearEvent();
 
       const Particle::Momentum p1( 0., 0.,  p->kinematics.in1p ), p2( 0., 0., -p->kinematics.in2p );
-      p->process()->setIncomingKinematics( p1, p2 ); // at some point introduce non head-on colliding beams?
+      proc->setIncomingKinematics( p1, p2 ); // at some point introduce non head-on colliding beams?
 
       DebuggingInsideLoop( Form( "Function f called -- some parameters:\n\t"
                                  "  pz(p1) = %5.2f  pz(p2) = %5.2f\n\t"
                                  "  remnant mode: %d",
                                  p->kinematics.in1p, p->kinematics.in2p, p->remnant_mode ) );
 
-      if ( p->vegas.first_run ) {
+      if ( !ctx->prepared ) {
 
         if ( Logger::get().level >= Logger::Debug ) {
           std::ostringstream oss; oss << p->kinematics.mode;
@@ -48,77 +49,123 @@ namespace CepGen
         }
         //PrintMessage( Form( "4 - after preparing the event kinematics: %.3e", tmr.elapsed()-now ) ); now = tmr.elapsed();
 
-        //--- prepare the function to be integrated
-        p->process()->prepareKinematics();
-
         //--- add central system
         cs1.setPdgId( p->kinematics.pair ); cs1.computeMass();
         cs2.setPdgId( p->kinematics.pair ); cs2.computeMass();
 
-        p->process()->clearRun();
-        p->vegas.first_run = false;
+        //--- prepare the function to be integrated
+        proc->prepareKinematics();
+
+        proc->clearRun();
+        ctx->prepared = true;
       }
-    } // event is not empty
+    }
+  }
+
+  double
+  f( double* x, size_t ndim, void* params )
+  {
+    ProfileRegion( "integrand" );
+
+    IntegrandContext* ctx = static_cast<IntegrandContext*>( params );
+    Process::GenericProcess* proc = ctx->process;
+    ctx->num_calls++;
+    std::shared_ptr<Event> ev = proc->event();
 
-    p->process()->setPoint( ndim, x );
+    if ( proc->hasEvent() ) prepareEvent( ctx );
+
+    proc->setPoint( ndim, x );
     if ( Logger::get().level >= Logger::DebugInsideLoop ) {
-      std::ostringstream oss; for ( unsigned int i=0; i<ndim; i++ ) { oss << x[i] << " "; }
-      DebuggingInsideLoop( Form( "Computing dim-%d point ( %s)", ndim, oss.str().c_str() ) );
+      ctx->stream.str( "" ); for ( unsigned int i=0; i<ndim; i++ ) { ctx->stream << x[i] << " "; }
+      DebuggingInsideLoop( Form( "Computing dim-%d point ( %s)", ndim, ctx->stream.str().c_str() ) );
     }
 
     //--- from this step on, the phase space point is supposed to be set by 'GenericProcess::setPoint()'
 
-    p->process()->beforeComputeWeight();
+    proc->beforeComputeWeight();
 
     Timer tmr; // start the timer
 
-    double integrand = p->process()->computeWeight();
+    double integrand = 0.;
+    {
+      ProfileRegion( "computeWeight" );
+      integrand = proc->computeWeight();
+    }
 
     if ( integrand < 0. ) return 0.;
 
-    //--- only fill in the process' Event object if storage is requested
-    //    or if taming functions are to be applied
+    //--- only fill in the process' Event object if storage is requested,
+    //    if taming functions are to be applied, or if histograms are filled
 
-    if ( !p->taming_functions.empty() || p->storage() ) p->process()->fillKinematics();
+    if ( !ctx->taming_functions.empty() || ctx->storage || ctx->kinematics ) {
+      ProfileRegion( "fillKinematics" );
+      proc->fillKinematics();
+    }
 
     //--- once the kinematics variables have been populated,
     //    can apply the collection of taming functions
 
     double taming = 1.0;
-    if ( p->taming_functions.has( "m_central" ) || p->taming_functions.has( "pt_central" ) ) {
-      const Particle::Momentum central_system( ev->getOneByRole( Particle::CentralParticle1 ).momentum() + ev->getOneByRole( Particle::CentralParticle2 ).momentum() );
-      taming *= p->taming_functions.eval( "m_central", central_system.mass() );
-      taming *= p->taming_functions.eval( "pt_central", central_system.pt() );
-    }
-    if ( p->taming_functions.has( "q2" ) ) {
-      taming *= p->taming_functions.eval( "q2", ev->getOneByRole( Particle::Parton1 ).momentum().mass() );
-      taming *= p->taming_functions.eval( "q2", ev->getOneByRole( Particle::Parton2 ).momentum().mass() );
+    if ( !ctx->taming_functions.empty() ) {
+      ProfileRegion( "taming functions" );
+      if ( ctx->taming_functions.has( "m_central" ) || ctx->taming_functions.has( "pt_central" ) ) {
+        const Particle::Momentum central_system( ev->getOneByRole( Particle::CentralParticle1 ).momentum() + ev->getOneByRole( Particle::CentralParticle2 ).momentum() );
+        taming *= ctx->taming_functions.eval( "m_central", central_system.mass() );
+        taming *= ctx->taming_functions.eval( "pt_central", central_system.pt() );
+      }
+      if ( ctx->taming_functions.has( "q2" ) ) {
+        taming *= ctx->taming_functions.eval( "q2", ev->getOneByRole( Particle::Parton1 ).momentum().mass() );
+        taming *= ctx->taming_functions.eval( "q2", ev->getOneByRole( Particle::Parton2 ).momentum().mass() );
+      }
     }
     integrand *= taming;
 
     //--- full event content (+ hadronisation) if generating events
 
-    if ( p->storage() ) {
+    if ( ctx->storage ) {
 
       ev->time_generation = tmr.elapsed();
 
       ev->time_total = tmr.elapsed();
-      p->process()->addGenerationTime( ev->time_total );
+      proc->addGenerationTime( ev->time_total );
 
       Debugging( Form( "Generation time:       %5.6f sec\n\t"
                        "Total time (gen+hadr): %5.6f sec",
                        ev->time_generation,
                        ev->time_total ) );
-
-      p->generation.last_event = ev;
     } // generating events
 
     if ( Logger::get().level>=Logger::DebugInsideLoop ) {
-      os.str( "" ); for ( unsigned int i=0; i<ndim; i++ ) { os << Form( "%10.8f ", x[i] ); }
-      Debugging( Form( "f value for dim-%d point ( %s): %4.4e", ndim, os.str().c_str(), integrand ) );
+      ctx->stream.str( "" ); for ( unsigned int i=0; i<ndim; i++ ) { ctx->stream << Form( "%10.8f ", x[i] ); }
+      Debugging( Form( "f value for dim-%d point ( %s): %4.4e", ndim, ctx->stream.str().c_str(), integrand ) );
     }
 
     return integrand;
   }
-}
 
+  void
+  f( const double* x, size_t num_points, size_t ndim, void* params, double* weights )
+  {
+    ProfileRegion( "integrand batch" );
+
+    IntegrandContext* ctx = static_cast<IntegrandContext*>( params );
+    Process::GenericProcess* proc = ctx->process;
+
+    //--- the full event content is needed; compute the points one by one
+    if ( !proc->hasEvent() || ctx->storage || ctx->kinematics || !ctx->taming_functions.empty() ) {
+      std::vector<double> point( ndim );
+      for ( size_t j=0; j<num_points; j++ ) {
+        for ( size_t i=0; i<ndim; i++ ) point[i] = x[i*num_points+j];
+        weights[j] = f( &point[0], ndim, params );
+      }
+      return;
+    }
+
+    ctx->num_calls += num_points;
+    prepareEvent( ctx );
+    proc->computeWeights( x, ndim, num_points, weights );
+    for ( size_t j=0; j<num_points; j++ ) {
+      if ( weights[j] < 0. ) weights[j] = 0.;
+    }
+  }
+}
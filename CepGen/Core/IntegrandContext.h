@@ -0,0 +1,57 @@
+#ifndef CepGen_Core_IntegrandContext_h
+#define CepGen_Core_IntegrandContext_h
+
+#include "CepGen/Parameters.h"
+
+#include <sstream>
+#include <memory>
+
+namespace CepGen
+{
+  /**
+   * Everything altered by one evaluation of the integrand: the process (and the
+   * event it fills), the taming functions evaluators, the storage flag, and some
+   * scratch space. The run parameters
+   * are only read, so that several contexts (each with its own replica of the
+   * process) may evaluate the integrand concurrently.
+   * \date Oct 2026
+   */
+  class IntegrandContext
+  {
+    public:
+      /// Build a context around a process owned by the caller
+      IntegrandContext( const Parameters* params, Process::GenericProcess* proc ) :
+        parameters( params ), process( proc ), taming_functions( params->taming_functions ),
+        storage( false ), kinematics( false ), prepared( false ), num_calls( 0 ) {}
+      /// Independent copy of this context, owning its own replica of the process
+      std::unique_ptr<IntegrandContext> clone() const {
+        Process::GenericProcess* proc = process->clone();
+        std::unique_ptr<IntegrandContext> out( new IntegrandContext( parameters, proc ) );
+        out->owned_process_.reset( proc );
+        out->prepared = prepared;
+        return out;
+      }
+
+      /// Run parameters, left untouched by the evaluations
+      const Parameters* parameters;
+      /// Process computing the weight (and filling its event) at each evaluation
+      Process::GenericProcess* process;
+      /// Copy of the run's taming functions, evaluated in this context only
+      TamingFunctionsCollection taming_functions;
+      /// Is the full event content to be computed at each evaluation?
+      bool storage;
+      /// Is the event kinematics to be computed at each evaluation (e.g. to fill the histograms)?
+      bool kinematics;
+      /// Were the process and its event prepared for this run?
+      bool prepared;
+      /// Number of evaluations performed in this context
+      unsigned long long num_calls;
+      /// Scratch stream for the debugging printouts
+      std::ostringstream stream;
+
+    private:
+      std::unique_ptr<Process::GenericProcess> owned_process_;
+  };
+}
+
+#endif
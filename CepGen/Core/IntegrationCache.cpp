@@ -0,0 +1,139 @@
+#include "CepGen/Core/IntegrationCache.h"
+
+#include <sstream>
+#include <cerrno>
+#include <sys/stat.h>
+
+namespace CepGen
+{
+  namespace
+  {
+    /// Version of the cache entries layout
+    constexpr unsigned short kCacheVersion = 1;
+  }
+
+  void
+  IntegrationCache::Entry::write( std::ostream& out ) const
+  {
+    out << "grid " << grid.bins << " " << grid.xi.size();
+    for ( const auto& val : grid.xi ) out << " " << Form( "%a", val );
+    out << "\n"
+      << "generation_state " << has_generation_state << "\n";
+    state.write( out );
+  }
+
+  IntegrationCache::Entry
+  IntegrationCache::Entry::read( std::istream& in, const std::string& file )
+  {
+    Entry out;
+    std::string key;
+    size_t size = 0;
+    in >> key >> out.grid.bins >> size;
+    if ( in.fail() || key != "grid" ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Corrupted integration results in \"%s\"", file.c_str() ), JustWarning );
+    }
+    out.grid.xi.resize( size );
+    for ( auto& val : out.grid.xi ) {
+      std::string str; in >> str;
+      val = std::strtod( str.c_str(), nullptr );
+    }
+    in >> key >> out.has_generation_state;
+    if ( in.fail() || key != "generation_state" ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Corrupted integration results in \"%s\"", file.c_str() ), JustWarning );
+    }
+    out.state = Checkpoint::read( in, file, JustWarning );
+    return out;
+  }
+
+  IntegrationCache::IntegrationCache( const std::string& directory ) :
+    directory_( directory )
+  {
+    if ( mkdir( directory.c_str(), 0755 ) != 0 && errno != EEXIST ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Failed to create the cache directory \"%s\"", directory.c_str() ), JustWarning );
+    }
+  }
+
+  std::string
+  IntegrationCache::description( const Parameters& params )
+  {
+    const Kinematics& kin = params.kinematics;
+    std::ostringstream os;
+    //--- all floating point values are given in their exact (hexadecimal) representation
+    os << "process=" << params.processName();
+    //--- the default settings are left out to keep the prepared integrations valid
+    if ( params.process() && !params.process()->settings().empty() ) os << "," << params.process()->settings();
+    os << ";mode=" << (int)kin.mode
+       << ";remnant_mode=" << (int)params.remnant_mode << "," << (int)kin.remnant_mode
+       << ";beams=" << Form( "%a,%a", kin.in1p, kin.in2p ) << "," << (int)kin.in1pdg << "," << (int)kin.in2pdg
+       << ";pair=" << (int)kin.pair
+       << ";cuts_mode=" << (int)kin.cuts_mode
+       << ";cuts=" << Form( "%a,%a,%a,%a,%a,%a,%a,%a,%a,%a,%a,%a,%a,%a,%a,%a,%a,%a",
+                            kin.pt_min, kin.pt_max, kin.e_min, kin.e_max, kin.eta_min, kin.eta_max,
+                            kin.mass_min, kin.mass_max, kin.mx_min, kin.mx_max, kin.q2_min, kin.q2_max,
+                            kin.w_min, kin.w_max, kin.ptdiff_min, kin.ptdiff_max, kin.qt_min, kin.qt_max );
+    os << ";taming=";
+    for ( const auto& tf : params.taming_functions ) os << "{" << tf.first << ":" << tf.second.expression << "}";
+    os << ";vegas=" << params.vegas.ncvg << "," << params.vegas.itvg << "," << params.vegas.npoints << ","
+       << params.vegas.seed << "," << params.vegas.stream << "," << params.vegas.refine_npoints << "," << Form( "%a", params.vegas.precision );
+    return os.str();
+  }
+
+  unsigned long long
+  IntegrationCache::hash( const std::string& str )
+  {
+    unsigned long long out = 0xcbf29ce484222325ull; // FNV offset basis
+    for ( const auto& c : str ) {
+      out ^= (unsigned char)c;
+      out *= 0x100000001b3ull; // FNV prime
+    }
+    return out;
+  }
+
+  std::string
+  IntegrationCache::file( const Parameters& params ) const
+  {
+    return Form( "%s/%016llx.cache", directory_.c_str(), hash( description( params ) ) );
+  }
+
+  bool
+  IntegrationCache::load( const Parameters& params, Entry& entry ) const
+  {
+    const std::string path = file( params );
+    std::ifstream in( path );
+    if ( !in.is_open() ) return false;
+    try {
+      std::string key, descr;
+      unsigned short version = 0;
+      if ( !( in >> key >> version ) || key != "cepgen_cache" || version != kCacheVersion ) {
+        throw Exception( __PRETTY_FUNCTION__, Form( "Unsupported cache entry \"%s\"", path.c_str() ), JustWarning );
+      }
+      //--- guard against a (very unlikely) hash collision
+      in >> key >> std::ws;
+      std::getline( in, descr );
+      if ( key != "description" || descr != description( params ) ) {
+        throw Exception( __PRETTY_FUNCTION__, Form( "Cache entry \"%s\" was produced for another run", path.c_str() ), JustWarning );
+      }
+      entry = Entry::read( in, path );
+    } catch ( Exception& e ) {
+      e.dump();
+      return false;
+    }
+    return true;
+  }
+
+  void
+  IntegrationCache::store( const Parameters& params, const Entry& entry ) const
+  {
+    const std::string path = file( params );
+    const bool written = writeAtomically( path, [&]( std::ostream& out ) {
+      out
+        << "cepgen_cache " << kCacheVersion << "\n"
+        << "description " << description( params ) << "\n";
+      entry.write( out );
+    } );
+    if ( !written ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Failed to write cache entry \"%s\"", path.c_str() ), JustWarning );
+    }
+    Debugging( Form( "Integration results cached in \"%s\"", path.c_str() ) );
+  }
+}
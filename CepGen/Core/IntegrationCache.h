@@ -0,0 +1,64 @@
+#ifndef CepGen_Core_IntegrationCache_h
+#define CepGen_Core_IntegrationCache_h
+
+#include "CepGen/Core/Checkpoint.h"
+
+#include <string>
+
+namespace CepGen
+{
+  /**
+   * Content-addressed storage of the integration results (cross section, adapted
+   * grid, and maxima of the generation grid cells), keyed on a hash of everything
+   * affecting the integrand. A run identical to a previous one can thus skip the
+   * integration and the generation grid preparation altogether.
+   * \note Each entry is written under a unique temporary name, then renamed, so
+   *  that concurrent writers (e.g. on a shared filesystem) never leave a partial file
+   * \date Oct 2026
+   */
+  class IntegrationCache
+  {
+    public:
+      /// Content of one cache entry
+      struct Entry
+      {
+        Entry() : has_generation_state( false ) {}
+        /// Write the entry into a stream
+        void write( std::ostream& os ) const;
+        /// Read an entry from a stream
+        /// \param[in] is Stream to read
+        /// \param[in] file Name of the stream's source, for the error messages
+        static Entry read( std::istream& is, const std::string& file );
+        /// Integration grid adapted to the function
+        Vegas::Grid grid;
+        /// Cross section and generation state right after the integration
+        Checkpoint state;
+        /// Are the maxima of the generation grid cells part of the entry?
+        bool has_generation_state;
+      };
+      /// Book a cache in a directory (created if needed)
+      explicit IntegrationCache( const std::string& directory );
+
+      /// Canonical description of everything affecting the integrand and its integration
+      static std::string description( const Parameters& params );
+      /// 64-bit FNV-1a hash of a string
+      static unsigned long long hash( const std::string& str );
+      /// Path to the entry for a set of run parameters
+      std::string file( const Parameters& params ) const;
+
+      /**
+       * Retrieve the entry for a set of run parameters
+       * \param[in] params Run parameters
+       * \param[out] entry Entry retrieved
+       * \return A boolean stating whether a valid entry was found
+       */
+      bool load( const Parameters& params, Entry& entry ) const;
+      /// Store the entry for a set of run parameters
+      void store( const Parameters& params, const Entry& entry ) const;
+
+    private:
+      std::string directory_;
+  };
+}
+
+#endif
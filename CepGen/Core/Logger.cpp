@@ -1,12 +1,37 @@
 #include "Logger.h"
 
+#include <thread>
+
 namespace CepGen
 {
+  namespace
+  {
+    /// Thread in which the static objects are initialised, i.e. the main one
+    const std::thread::id main_thread = std::this_thread::get_id();
+    /// Logger of the current thread (unless it is the main one, or it inherited the main logger)
+    thread_local std::unique_ptr<Logger> thread_logger;
+  }
+
   Logger&
   Logger::get()
   {
-    static Logger log;
-    return log;
+    if ( thread_logger ) return *thread_logger;
+    if ( std::this_thread::get_id() == main_thread ) return main();
+    thread_logger.reset( new Logger( main() ) );
+    return *thread_logger;
+  }
+
+  Logger&
+  Logger::main()
+  {
+    static Logger logger;
+    return logger;
+  }
+
+  void
+  Logger::inherit( const Logger& parent )
+  {
+    thread_logger.reset( new Logger( parent ) );
   }
 
   std::ostream&
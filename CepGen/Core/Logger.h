@@ -8,6 +8,9 @@ namespace CepGen
 {
   /**
    * \brief General purposes logger
+   * \note Each thread has its own logger (threshold and output stream), so that
+   *  independent runs can be steered concurrently from several threads. The
+   *  logger of a new thread starts with the settings of the main thread's one
    * \author Laurent Forthomme <laurent.forthomme@cern.ch>
    * \date 15 Oct 2015
    */
@@ -17,14 +20,20 @@ namespace CepGen
       /// Logging threshold for the output stream
       enum LoggingLevel { Nothing=0, Error, Warning, Information, Debug, DebugInsideLoop };
 
-    private:
       /// Initialize a logging object
-      Logger() : level( Warning ), outputStream( std::cout ) {}
-      ~Logger() {}
+      Logger( LoggingLevel lvl=Warning, std::ostream& os=std::cout ) : level( lvl ), outputStream( os ) {}
 
-    public:
-      /// Retrieve the running instance of the logger
+      /// Retrieve the logger of the calling thread (copied from the main thread's one at its first call)
       static Logger& get();
+      /// Logger of the main thread, i.e. the one of the program
+      static Logger& main();
+      /**
+       * Let the calling thread log as another one (e.g. a worker thread as the thread
+       * which spawned it, rather than as the main thread). The settings of the parent
+       * logger are copied, thus later changes on either side are not propagated.
+       * \param[in] parent Logger to copy the settings from
+       */
+      static void inherit( const Logger& parent );
 
       /// Redirect the logger to a given output stream
       friend std::ostream& operator<<( std::ostream& os, const Logger::LoggingLevel& lvl );
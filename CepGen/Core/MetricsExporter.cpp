@@ -0,0 +1,65 @@
+#include "CepGen/Core/MetricsExporter.h"
+#include "CepGen/Core/Exception.h"
+#include "CepGen/Core/utils.h"
+
+#include <sstream>
+#include <chrono>
+
+namespace CepGen
+{
+  MetricsExporter::MetricsExporter( const std::string& file, double period, Collector collect ) :
+    file_( file ), period_( period ), collect_( collect ), logger_( Logger::get() ), stop_( false ),
+    thread_( &MetricsExporter::run, this )
+  {}
+
+  MetricsExporter::~MetricsExporter()
+  {
+    {
+      std::lock_guard<std::mutex> lock( mutex_ );
+      stop_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+    write();
+  }
+
+  void
+  MetricsExporter::run()
+  {
+    Logger::inherit( logger_ );
+    std::unique_lock<std::mutex> lock( mutex_ );
+    while ( !stop_ ) {
+      lock.unlock();
+      write();
+      lock.lock();
+      wake_.wait_for( lock, std::chrono::duration<double>( period_ ), [this]{ return stop_; } );
+    }
+  }
+
+  void
+  MetricsExporter::write() const
+  {
+    if ( !writeAtomically( file_, [this]( std::ostream& out ) { out << format( collect_() ); } ) ) {
+      InWarning( Form( "Failed to write the metrics file \"%s\"", file_.c_str() ) );
+    }
+  }
+
+  std::string
+  MetricsExporter::format( const std::vector<Metric>& metrics )
+  {
+    std::ostringstream os;
+    std::string last_name;
+    for ( const auto& met : metrics ) {
+      //--- the description and type are only given once per metric
+      if ( met.name != last_name ) {
+        os << "# HELP " << met.name << " " << met.help << "\n"
+           << "# TYPE " << met.name << " " << met.type << "\n";
+        last_name = met.name;
+      }
+      os << met.name;
+      if ( !met.labels.empty() ) os << "{" << met.labels << "}";
+      os << " " << Form( "%.10g", met.value ) << "\n";
+    }
+    return os.str();
+  }
+}
@@ -0,0 +1,74 @@
+#ifndef CepGen_Core_MetricsExporter_h
+#define CepGen_Core_MetricsExporter_h
+
+#include "CepGen/Core/Logger.h"
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace CepGen
+{
+  /**
+   * Periodic export of a set of run metrics (events produced, throughput, ...)
+   * into a text file, in the Prometheus exposition format, for a monitoring
+   * agent to scrape. The metrics are collected and written by a background
+   * thread, so that the production is never slowed down by the export.
+   * \note The file is written under a temporary name, then renamed, so that
+   *  a scraper never reads a partial file
+   * \date Oct 2026
+   */
+  class MetricsExporter
+  {
+    public:
+      /// One sample of a metric
+      struct Metric
+      {
+        Metric( const char* name_, const char* type_, const char* help_, double value_, const std::string& labels_="" ) :
+          name( name_ ), type( type_ ), help( help_ ), labels( labels_ ), value( value_ ) {}
+        /// Name of the metric (e.g. cepgen_events_generated)
+        std::string name;
+        /// Type of the metric (counter or gauge)
+        std::string type;
+        /// Human-readable description
+        std::string help;
+        /// Labels distinguishing several samples of the same metric (e.g. queue="points")
+        std::string labels;
+        double value;
+      };
+      /// Function collecting the current values of all metrics, called from the export thread
+      typedef std::function<std::vector<Metric>()> Collector;
+
+      /**
+       * Start the periodic export
+       * \param[in] file Path to the metrics file
+       * \param[in] period Time between two exports, in seconds
+       * \param[in] collect Function collecting the metrics (to be thread-safe)
+       */
+      MetricsExporter( const std::string& file, double period, Collector collect );
+      /// Stop the periodic export, and write a last snapshot of the metrics
+      ~MetricsExporter();
+
+      /// Format a collection of metrics in the Prometheus text exposition format
+      static std::string format( const std::vector<Metric>& metrics );
+
+    private:
+      void run();
+      void write() const;
+
+      std::string file_;
+      double period_;
+      Collector collect_;
+      /// Logger of the thread which started the export
+      const Logger logger_;
+      std::mutex mutex_;
+      std::condition_variable wake_;
+      bool stop_;
+      std::thread thread_;
+  };
+}
+
+#endif
@@ -3,23 +3,24 @@
 namespace CepGen
 {
   Parameters::Parameters() :
-    remnant_mode( SuriYennie ),
-    store_( false )
+    remnant_mode( SuriYennie ), trace_capacity( 100000 )
   {}
 
   Parameters::Parameters( Parameters& param ) :
     remnant_mode( param.remnant_mode ),
     kinematics( param.kinematics ), vegas( param.vegas ), generation( param.generation ),
-    taming_functions( param.taming_functions ),
-    process_( std::move( param.process_ ) ),
-    store_( param.store_ )
+    cocktail( param.cocktail ), scan( param.scan ), taming_functions( param.taming_functions ),
+    histograms( param.histograms ), report_file( param.report_file ),
+    trace_file( param.trace_file ), trace_capacity( param.trace_capacity ),
+    process_( std::move( param.process_ ) )
   {}
 
   Parameters::Parameters( const Parameters& param ) :
     remnant_mode( param.remnant_mode ),
     kinematics( param.kinematics ), vegas( param.vegas ), generation( param.generation ),
-    taming_functions( param.taming_functions ),
-    store_( param.store_ )
+    cocktail( param.cocktail ), scan( param.scan ), taming_functions( param.taming_functions ),
+    histograms( param.histograms ), report_file( param.report_file ),
+    trace_file( param.trace_file ), trace_capacity( param.trace_capacity )
   {}
 
   Parameters::~Parameters()
@@ -61,6 +62,22 @@ namespace CepGen
       << std::endl
       << std::setw( wt ) << "Events generation? " << ( pretty ? yesno( generation.enabled ) : std::to_string( generation.enabled ) ) << std::endl
       << std::setw( wt ) << "Number of events to generate" << ( pretty ? boldify( generation.maxgen ) : std::to_string( generation.maxgen ) ) << std::endl
+      << std::setw( wt ) << "Checkpoints" << ( generation.checkpoint_every > 0 ? Form( "every %d events in %s", generation.checkpoint_every, generation.checkpoint_file.c_str() ) : "none" ) << std::endl
+      << std::setw( wt ) << "Metrics export" << ( !generation.metrics_file.empty() ? Form( "every %g s in %s", generation.metrics_period, generation.metrics_file.c_str() ) : "none" ) << std::endl;
+    for ( unsigned short i=0; i<cocktail.size(); i++ ) {
+      std::ostringstream chan; chan << cocktail[i].mode << ", " << cocktail[i].remnant_mode << ", " << cocktail[i].pair;
+      os << std::setw( wt ) << ( i == 0 ? "Cocktail channels" : "" ) << chan.str() << std::endl;
+    }
+    if ( !scan.values.empty() ) {
+      os << std::setw( wt ) << "Cross section scan" << Form( "%s in [%g, %g] (%zu points)", scan.parameter.c_str(), scan.values.front(), scan.values.back(), scan.values.size() ) << ( scan.warm_start ? ", warm-started" : "" ) << std::endl;
+    }
+    for ( unsigned short i=0; i<histograms.size(); i++ ) {
+      const Histogram& hist = histograms[i];
+      os << std::setw( wt ) << ( i == 0 ? "Differential cross sections" : "" ) << Form( "%s: %d bins in [%g, %g]", hist.variable().c_str(), hist.numBins(), hist.binLow( 0 ), hist.binHigh( hist.numBins()-1 ) ) << std::endl;
+    }
+    os
+      << std::setw( wt ) << "Run report" << ( report_file.empty() ? "none" : report_file ) << std::endl
+      << std::setw( wt ) << "Timeline trace" << ( trace_file.empty() ? "none" : Form( "%s (%d regions/thread)", trace_file.c_str(), trace_capacity ) ) << std::endl
       << std::setw( wt ) << "Verbosity level " << Logger::get().level << std::endl
       << std::endl
       << std::setfill( '-' ) << std::setw( wb+6 ) << ( pretty ? boldify( " Vegas integration parameters " ) : "Vegas integration parameters" ) << std::setfill( ' ' ) << std::endl
@@ -68,6 +85,11 @@ namespace CepGen
       << std::setw( wt ) << "Maximum number of iterations" << ( pretty ? boldify( vegas.itvg ) : std::to_string( vegas.itvg ) ) << std::endl
       << std::setw( wt ) << "Number of function calls" << vegas.ncvg << std::endl
       << std::setw( wt ) << "Number of points to try per bin" << vegas.npoints << std::endl
+      << std::setw( wt ) << "Points to refine a bin maximum" << vegas.refine_npoints << std::endl
+      << std::setw( wt ) << "Target relative precision" << ( vegas.precision > 0. ? Form( "%g", vegas.precision ) : std::string( "none" ) ) << std::endl
+      << std::setw( wt ) << "Random numbers seed" << vegas.seed << std::endl
+      << std::setw( wt ) << "Random numbers stream" << vegas.stream << std::endl
+      << std::setw( wt ) << "Integration cache" << ( vegas.cache_directory.empty() ? "none" : vegas.cache_directory ) << std::endl
       << std::endl
       << std::setfill('_') << std::setw( wb ) << "_/¯ EVENTS KINEMATICS ¯\\_" << std::setfill( ' ' ) << std::endl
       << std::endl
@@ -0,0 +1,118 @@
+#include "CepGen/Core/Profiler.h"
+#include "CepGen/Core/Exception.h"
+#include "CepGen/Core/utils.h"
+
+#include <sstream>
+#include <cmath>
+
+namespace CepGen
+{
+  Profiler&
+  Profiler::get()
+  {
+    static Profiler prof;
+    return prof;
+  }
+
+  unsigned short
+  Profiler::region( const char* name )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    for ( unsigned short i=0; i<regions_.size(); i++ ) {
+      if ( regions_[i] == name ) return i;
+    }
+    regions_.emplace_back( name );
+    return regions_.size()-1;
+  }
+
+  Profiler::ThreadRecords&
+  Profiler::threadRecords()
+  {
+    thread_local std::shared_ptr<ThreadRecords> records;
+    if ( !records ) {
+      records = std::make_shared<ThreadRecords>();
+      Profiler& prof = get();
+      std::lock_guard<std::mutex> lock( prof.mutex_ );
+      prof.threads_.emplace_back( records );
+    }
+    return *records;
+  }
+
+  void
+  Profiler::record( unsigned short region, unsigned long long duration )
+  {
+    ThreadRecords& thr = threadRecords();
+    std::lock_guard<std::mutex> lock( thr.mutex );
+    if ( region >= thr.records.size() ) thr.records.resize( region+1 );
+    Record& rec = thr.records[region];
+    rec.calls++;
+    rec.total += duration;
+    //--- logarithmic binning, with num_sub_bins_ bins per factor 2
+    unsigned short bin = duration;
+    if ( duration >= num_sub_bins_ ) {
+      const unsigned short msb = 63-__builtin_clzll( duration ), shift = msb-2;
+      bin = msb*num_sub_bins_+( ( duration >> shift ) & ( num_sub_bins_-1 ) );
+    }
+    rec.histogram[std::min<unsigned short>( bin, num_bins_-1 )]++;
+  }
+
+  void
+  Profiler::Record::merge( const Record& oth )
+  {
+    calls += oth.calls;
+    total += oth.total;
+    for ( unsigned short i=0; i<num_bins_; i++ ) histogram[i] += oth.histogram[i];
+  }
+
+  double
+  Profiler::Record::quantile( double q ) const
+  {
+    const unsigned long long target = ceil( q*calls );
+    unsigned long long sum = 0;
+    for ( unsigned short i=0; i<num_bins_; i++ ) {
+      sum += histogram[i];
+      if ( sum < target || sum == 0 ) continue;
+      if ( i < num_sub_bins_ ) return i;
+      //--- centre of the bin
+      const unsigned short msb = i/num_sub_bins_, sub = i%num_sub_bins_;
+      return ldexp( num_sub_bins_+sub+0.5, msb-2 );
+    }
+    return 0.;
+  }
+
+  void
+  Profiler::summary( const char* stage )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    std::vector<Record> merged( regions_.size() );
+    unsigned short num_threads = 0;
+    for ( auto& thr : threads_ ) {
+      std::lock_guard<std::mutex> thr_lock( thr->mutex );
+      bool active = false;
+      for ( unsigned short i=0; i<thr->records.size() && i<merged.size(); i++ ) {
+        if ( thr->records[i].calls > 0 ) active = true;
+        merged[i].merge( thr->records[i] );
+        thr->records[i] = Record();
+      }
+      if ( active ) num_threads++;
+    }
+    //--- forget about the threads which were terminated in the meantime
+    for ( auto it=threads_.begin(); it!=threads_.end(); ) {
+      if ( it->use_count() == 1 ) it = threads_.erase( it );
+      else ++it;
+    }
+    if ( num_threads == 0 ) return;
+
+    std::ostringstream os;
+    os << Form( "Profiling summary for the %s (%d thread(s))\n\t", stage, num_threads )
+       << Form( "%-20s %12s %12s %10s %10s %10s %10s", "region", "calls", "total (ms)", "mean (us)", "p50 (us)", "p90 (us)", "p99 (us)" );
+    for ( unsigned short i=0; i<merged.size(); i++ ) {
+      const Record& rec = merged[i];
+      if ( rec.calls == 0 ) continue;
+      os << "\n\t" << Form( "%-20s %12llu %12.3f %10.3f %10.3f %10.3f %10.3f",
+        regions_[i].c_str(), rec.calls, rec.total*1.e-6, rec.total*1.e-3/rec.calls,
+        rec.quantile( 0.5 )*1.e-3, rec.quantile( 0.9 )*1.e-3, rec.quantile( 0.99 )*1.e-3 );
+    }
+    Information( os.str() );
+  }
+}
@@ -0,0 +1,95 @@
+#ifndef CepGen_Core_Profiler_h
+#define CepGen_Core_Profiler_h
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+
+#ifdef CEPGEN_PROFILING
+#define ProfilerConcat_( a, b ) a ## b
+#define ProfilerConcat( a, b ) ProfilerConcat_( a, b )
+/// Profile the remainder of the current scope under a given region name
+#define ProfileRegion( name ) \
+  static const unsigned short ProfilerConcat( profiler_region_, __LINE__ ) = CepGen::Profiler::get().region( name ); \
+  CepGen::Profiler::Scope ProfilerConcat( profiler_scope_, __LINE__ )( ProfilerConcat( profiler_region_, __LINE__ ) )
+#else
+#define ProfileRegion( name )
+#endif
+
+namespace CepGen
+{
+  /**
+   * Low-overhead profiler for the hot path of the integrand. Each thread
+   * accumulates the number of calls, the total time, and a (logarithmic)
+   * histogram of the durations of each region on its own; the records of all
+   * threads are only merged when the summary is printed. Each thread's records
+   * are guarded by their own (uncontended) lock, so that a summary may be
+   * printed while other threads are still running.
+   * The regions are defined with the ProfileRegion macro, only enabled when
+   * compiled with the CEPGEN_PROFILING flag (cmake -DCEPGEN_PROFILING=ON).
+   * \date Oct 2026
+   */
+  class Profiler
+  {
+    public:
+      /// Retrieve the running instance of the profiler
+      static Profiler& get();
+
+      /// Register a new region, and retrieve its identifier
+      unsigned short region( const char* name );
+      /// Print the summary table of all regions profiled since the last summary, then reset the counters
+      /// \param[in] stage Name of the step being summarised (integration, events generation, ...)
+      void summary( const char* stage );
+
+      /// Measure the time spent between its construction and its destruction
+      class Scope
+      {
+        public:
+          explicit Scope( unsigned short region ) : region_( region ), start_( clock::now() ) {}
+          ~Scope() { Profiler::record( region_, std::chrono::duration_cast<std::chrono::nanoseconds>( clock::now()-start_ ).count() ); }
+
+        private:
+          typedef std::chrono::steady_clock clock;
+          const unsigned short region_;
+          const clock::time_point start_;
+      };
+
+    private:
+      Profiler() {}
+
+      /// Number of histogram bins per factor 2 in duration
+      static constexpr unsigned short num_sub_bins_ = 4;
+      /// Number of bins in the durations histograms
+      static constexpr unsigned short num_bins_ = 64*num_sub_bins_;
+      /// Statistics collected for one region
+      struct Record
+      {
+        Record() : calls( 0 ), total( 0 ), histogram( num_bins_, 0 ) {}
+        void merge( const Record& oth );
+        /// Estimate of a given quantile of the durations, in ns
+        double quantile( double q ) const;
+        unsigned long long calls, total;
+        std::vector<unsigned long long> histogram;
+      };
+      /// Statistics of all regions collected by one thread
+      struct ThreadRecords
+      {
+        /// Guard against a summary being printed while the thread is recording
+        std::mutex mutex;
+        std::vector<Record> records;
+      };
+      /// Add one duration (in ns) to the current thread's statistics of a region
+      static void record( unsigned short region, unsigned long long duration );
+      /// Statistics of all regions, for the current thread
+      static ThreadRecords& threadRecords();
+
+      std::mutex mutex_;
+      std::vector<std::string> regions_;
+      /// Statistics of all threads which ever entered a region
+      std::vector<std::shared_ptr<ThreadRecords> > threads_;
+  };
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "CepGen/Core/RandomGenerator.h"
+
+namespace CepGen
+{
+  namespace
+  {
+    /// Multipliers and Weyl sequence increments for the Philox4x32 rounds
+    constexpr std::uint32_t kPhiloxM0 = 0xD2511F53, kPhiloxM1 = 0xCD9E8D57;
+    constexpr std::uint32_t kPhiloxW0 = 0x9E3779B9, kPhiloxW1 = 0xBB67AE85;
+
+    /// Interface to the GSL random numbers generators
+    struct GslState { RandomGenerator* rng; };
+    void gslSet( void*, unsigned long ) {} // seeding is handled by the RandomGenerator object
+    unsigned long gslGet( void* state ) { return static_cast<GslState*>( state )->rng->integer(); }
+    double gslGetDouble( void* state ) { return static_cast<GslState*>( state )->rng->uniform(); }
+    const gsl_rng_type gsl_philox_type = {
+      "philox4x32-10", 0xffffffffUL, 0, sizeof( GslState ), &gslSet, &gslGet, &gslGetDouble
+    };
+  }
+
+  RandomGenerator::RandomGenerator( unsigned long long seed, unsigned long long stream ) :
+    seed_( seed ), stream_( stream ), block_( 0 ), idx_( 4 )
+  {}
+
+  RandomGenerator::Block
+  RandomGenerator::philox( std::uint64_t block ) const
+  {
+    //--- the lower half of the counter holds the position, the upper half the stream index
+    Block ctr = { { (std::uint32_t)block, (std::uint32_t)( block >> 32 ), (std::uint32_t)stream_, (std::uint32_t)( stream_ >> 32 ) } };
+    std::uint32_t k0 = seed_, k1 = seed_ >> 32;
+    for ( unsigned short i=0; i<10; i++ ) {
+      const std::uint64_t p0 = (std::uint64_t)kPhiloxM0*ctr[0], p1 = (std::uint64_t)kPhiloxM1*ctr[2];
+      ctr = { { (std::uint32_t)( p1 >> 32 )^ctr[1]^k0, (std::uint32_t)p1, (std::uint32_t)( p0 >> 32 )^ctr[3]^k1, (std::uint32_t)p0 } };
+      k0 += kPhiloxW0;
+      k1 += kPhiloxW1;
+    }
+    return ctr;
+  }
+
+  void
+  RandomGenerator::fill( double* out, size_t num )
+  {
+    size_t i = 0;
+    //--- first consume what is left in the current block
+    while ( i < num && idx_ < 4 ) out[i++] = toDouble( buf_[idx_++] );
+    //--- then fill the buffer by whole blocks
+    for ( ; i+4 <= num; i += 4 ) {
+      const Block blk = philox( block_++ );
+      for ( unsigned short j=0; j<4; j++ ) out[i+j] = toDouble( blk[j] );
+    }
+    while ( i < num ) out[i++] = uniform();
+  }
+
+  void
+  RandomGenerator::seek( unsigned long long pos )
+  {
+    block_ = pos/4;
+    idx_ = 4;
+    if ( pos % 4 != 0 ) {
+      refill();
+      idx_ = pos % 4;
+    }
+  }
+
+  gsl_rng*
+  RandomGenerator::gslEngine( RandomGenerator* rng )
+  {
+    gsl_rng* out = gsl_rng_alloc( &gsl_philox_type );
+    static_cast<GslState*>( out->state )->rng = rng;
+    return out;
+  }
+}
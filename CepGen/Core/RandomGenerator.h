@@ -0,0 +1,86 @@
+#ifndef CepGen_Core_RandomGenerator_h
+#define CepGen_Core_RandomGenerator_h
+
+#include <gsl/gsl_rng.h>
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace CepGen
+{
+  /**
+   * Counter-based pseudo-random numbers generator, implementing the Philox4x32-10
+   * algorithm (J. Salmon et al., SC'11). Each draw is a pure function of the seed, the
+   * stream index, and the position in the stream, hence:
+   * - two generators built with the same seed and stream index yield the same
+   *   sequence, whatever the machine or the thread they are running on,
+   * - generators sharing a seed but using different stream indices yield
+   *   statistically independent sequences, which allows to feed several threads
+   *   or jobs without any synchronisation,
+   * - any position in a stream can be reached without drawing the previous numbers.
+   * \date Oct 2026
+   */
+  class RandomGenerator
+  {
+    public:
+      /// Build a generator
+      /// \param[in] seed Seed (key) of the sequences
+      /// \param[in] stream Index of the independent sequence to draw from
+      explicit RandomGenerator( unsigned long long seed=0, unsigned long long stream=0 );
+
+      /// Seed used to build this generator
+      unsigned long long seed() const { return seed_; }
+      /// Index of the sequence drawn from
+      unsigned long long stream() const { return stream_; }
+      /// Build an independent generator sharing this generator's seed
+      /// \param[in] stream Index of the new sequence
+      RandomGenerator split( unsigned long long stream ) const { return RandomGenerator( seed_, stream ); }
+
+      /// Draw a random number uniformly distributed in \f$]0,1[\f$
+      double uniform() {
+        if ( idx_ == 4 ) refill();
+        return toDouble( buf_[idx_++] );
+      }
+      /// Draw a random number uniformly distributed in \f$]a,b[\f$
+      double uniform( double a, double b ) { return a + ( b-a )*uniform(); }
+      /// Draw a raw 32-bit random integer
+      std::uint32_t integer() {
+        if ( idx_ == 4 ) refill();
+        return buf_[idx_++];
+      }
+      /// Fill a buffer with random numbers uniformly distributed in \f$]0,1[\f$
+      /// \param[out] out Buffer to fill
+      /// \param[in] num Number of values to draw
+      void fill( double* out, size_t num );
+
+      /// Number of 32-bit values already drawn from this stream
+      unsigned long long position() const { return 4*block_-( 4-idx_ ); }
+      /// Move to any position in the stream
+      /// \param[in] pos Number of 32-bit values to skip from the beginning of the stream
+      void seek( unsigned long long pos );
+
+      /// Allocate a GSL generator drawing its numbers from a RandomGenerator object
+      /// \note The returned object is to be freed with gsl_rng_free, and must not outlive the RandomGenerator object
+      static gsl_rng* gslEngine( RandomGenerator* rng );
+
+    private:
+      typedef std::array<std::uint32_t,4> Block;
+      /// Compute the Philox4x32-10 output for a given counter and the current key
+      Block philox( std::uint64_t block ) const;
+      /// Compute the next block of four random values
+      void refill() { buf_ = philox( block_++ ); idx_ = 0; }
+      /// Map a 32-bit integer to \f$]0,1[\f$ (zero is never returned)
+      static double toDouble( std::uint32_t i ) { return ( i+0.5 )*2.3283064365386963e-10; }
+
+      unsigned long long seed_, stream_;
+      /// Index of the next block of four values to compute
+      std::uint64_t block_;
+      /// Last block of random values computed
+      Block buf_;
+      /// Position of the next value to be consumed in the last block
+      unsigned short idx_;
+  };
+}
+
+#endif
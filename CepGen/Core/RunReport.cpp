@@ -0,0 +1,82 @@
+#include "CepGen/Core/RunReport.h"
+#include "CepGen/Version.h"
+
+#include <cmath>
+
+namespace CepGen
+{
+  namespace
+  {
+    /// JSON representation of a floating point value
+    std::string number( double val ) { return std::isfinite( val ) ? Form( "%.10g", val ) : std::string( "null" ); }
+    /// JSON representation of a string
+    std::string quote( const std::string& str ) {
+      std::string out = "\"";
+      for ( const auto& ch : str ) {
+        if ( ch == '"' || ch == '\\' ) out += '\\';
+        if ( (unsigned char)ch < 0x20 ) { out += Form( "\\u%04x", ch ); continue; }
+        out += ch;
+      }
+      return out+"\"";
+    }
+  }
+
+  RunReport::RunReport() :
+    configuration_hash( 0 ), seed( 0 ), num_dimensions( 0 ),
+    cross_section( -1. ), cross_section_error( -1. ), integration_restored( false ),
+    num_events( 0 ), events_time( 0. ), num_function_calls( 0 ), wall_time( 0. ), peak_memory( 0 )
+  {}
+
+  std::string
+  RunReport::json() const
+  {
+    const double sampling_efficiency = ( vegas.sampling_calls > 0 ) ? (double)vegas.num_sampled/vegas.sampling_calls : 0.;
+    std::ostringstream os;
+    os
+      << "{\n"
+      << "  \"version\": " << quote( version() ) << ",\n"
+      << "  \"configuration\": {\n"
+      << "    \"hash\": " << quote( Form( "%016llx", configuration_hash ) ) << ",\n"
+      << "    \"process\": " << quote( process ) << ",\n"
+      << "    \"seed\": " << seed << ",\n"
+      << "    \"num_dimensions\": " << num_dimensions << "\n"
+      << "  },\n"
+      << "  \"integration\": {\n"
+      << "    \"cross_section\": " << number( cross_section ) << ",\n"
+      << "    \"cross_section_error\": " << number( cross_section_error ) << ",\n"
+      << "    \"restored\": " << ( integration_restored ? "true" : "false" ) << ",\n"
+      << "    \"num_iterations\": " << vegas.num_iterations << ",\n"
+      << "    \"chi2\": " << number( vegas.chi2 ) << ",\n"
+      << "    \"function_calls\": " << vegas.integration_calls << ",\n"
+      << "    \"time\": " << number( vegas.integration_time ) << "\n"
+      << "  },\n"
+      << "  \"grid_preparation\": {\n"
+      << "    \"function_calls\": " << vegas.grid_calls << ",\n"
+      << "    \"efficiency\": " << number( vegas.grid_efficiency ) << ",\n"
+      << "    \"time\": " << number( vegas.grid_time ) << "\n"
+      << "  },\n"
+      << "  \"generation\": {\n"
+      << "    \"num_events\": " << num_events << ",\n"
+      << "    \"num_sampled\": " << vegas.num_sampled << ",\n"
+      << "    \"function_calls\": " << vegas.sampling_calls << ",\n"
+      << "    \"efficiency\": " << number( sampling_efficiency ) << ",\n"
+      << "    \"sampling_time\": " << number( vegas.sampling_time ) << ",\n"
+      << "    \"events_time\": " << number( events_time ) << ",\n"
+      << "    \"mean_time_per_event\": " << number( ( num_events > 0 ) ? ( vegas.sampling_time+events_time )/num_events : 0. ) << "\n"
+      << "  },\n"
+      << "  \"function_calls\": " << num_function_calls << ",\n"
+      << "  \"wall_time\": " << number( wall_time ) << ",\n"
+      << "  \"peak_memory_kb\": " << peak_memory << "\n"
+      << "}\n";
+    return os.str();
+  }
+
+  void
+  RunReport::write( const std::string& file ) const
+  {
+    if ( !writeAtomically( file, [this]( std::ostream& out ) { out << json(); } ) ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Failed to write the run report \"%s\"", file.c_str() ), JustWarning );
+    }
+    Information( Form( "Run report written in \"%s\"", file.c_str() ) );
+  }
+}
@@ -0,0 +1,51 @@
+#ifndef CepGen_Core_RunReport_h
+#define CepGen_Core_RunReport_h
+
+#include "CepGen/Core/Vegas.h"
+
+#include <string>
+
+namespace CepGen
+{
+  /**
+   * Machine-readable summary of a run (configuration, integration and generation
+   * counters, timings, memory usage), to be ingested by a bookkeeping database.
+   * \date Oct 2026
+   */
+  struct RunReport
+  {
+    RunReport();
+    /// Summary in the JSON format
+    std::string json() const;
+    /// Write the JSON summary into a file
+    /// \note The file is written under a temporary name, then renamed
+    void write( const std::string& file ) const;
+
+    /// Hash of the canonical description of the integrand (see IntegrationCache::description)
+    unsigned long long configuration_hash;
+    /// Name of the process
+    std::string process;
+    /// Seed of the random numbers sequences
+    unsigned long long seed;
+    /// Number of dimensions of the integration
+    unsigned int num_dimensions;
+    /// Cross section and its error, in pb
+    double cross_section, cross_section_error;
+    /// Were the integration results restored (from a cache, a gridpack or a checkpoint) rather than computed?
+    bool integration_restored;
+    /// Counters and timings of the integrator
+    Vegas::Statistics vegas;
+    /// Number of events generated
+    unsigned int num_events;
+    /// Time spent in the computation of the events kinematics, in s
+    double events_time;
+    /// Total number of function calls in the default evaluation context
+    unsigned long long num_function_calls;
+    /// Time since the start of the run, in s
+    double wall_time;
+    /// Maximal resident memory size of the job, in kB
+    long peak_memory;
+  };
+}
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef CepGen_Core_Simd_h
+#define CepGen_Core_Simd_h
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+//--- vector extensions of GCC, on the architectures without excess precision for the double type
+#if defined( __GNUC__ ) && !defined( __clang__ ) && ( defined( __SSE2__ ) || defined( __aarch64__ ) )
+#define CEPGEN_SIMD
+#endif
+#if defined( CEPGEN_SIMD ) && defined( __SSE2__ )
+#include <immintrin.h>
+#endif
+
+namespace CepGen
+{
+  /**
+   * Arithmetics on a set of double precision values (or lanes) computed at once.
+   * A computation written once for a generic lane type V may be instantiated for a single value
+   * (V = double, the standard library functions being used), or for the Vector type, mapped by
+   * the compiler onto the SIMD instructions enabled at build time (two lanes with SSE2, four with
+   * AVX, as enabled by the CEPGEN_SIMD_NATIVE build option). The conditions on the lanes are held
+   * in masks, and the branches replaced by select calls.
+   * \note The transcendental functions of the Vector type are evaluated from Taylor expansions
+   *  after a range reduction, within a few units in the last place of the standard ones (the
+   *  subnormal numbers being out of their scope)
+   */
+  namespace Simd
+  {
+    /// Mask of the lanes fulfilling a condition (a boolean for a single value)
+    template<typename V> using Mask = decltype( std::declval<V>() < std::declval<V>() );
+
+    //----- single value
+
+    /// Number of lanes held in a value
+    template<typename V> inline constexpr unsigned short width() { return sizeof( V )/sizeof( double ); }
+    /// Value with all its lanes set to x
+    template<typename V> inline V broadcast( double x ) { return x; }
+    /// Value of the lanes stored contiguously from p (unaligned)
+    template<typename V> inline V load( const double* p ) { V v; memcpy( &v, p, sizeof( V ) ); return v; }
+    /// Store the lanes of v contiguously from p (unaligned)
+    template<typename V> inline void store( double* p, const V& v ) { memcpy( p, &v, sizeof( V ) ); }
+
+    inline double get( double v, unsigned short ) { return v; }
+    inline void set( double& v, unsigned short, double val ) { v = val; }
+    inline bool any( bool m ) { return m; }
+    inline double select( bool m, double a, double b ) { return m ? a : b; }
+    inline double abs( double x ) { return std::fabs( x ); }
+    inline double min( double a, double b ) { return ( a < b ) ? a : b; }
+    inline double sqrt( double x ) { return std::sqrt( x ); }
+    inline double exp( double x ) { return std::exp( x ); }
+    inline double expm1( double x ) { return std::expm1( x ); }
+    inline double log( double x ) { return std::log( x ); }
+    inline double pow( double x, double y ) { return std::pow( x, y ); }
+    inline double cos( double x ) { return std::cos( x ); }
+    inline void sincos( double x, double& s, double& c ) { s = std::sin( x ); c = std::cos( x ); }
+    inline double atan2( double y, double x ) { return std::atan2( y, x ); }
+
+#ifdef CEPGEN_SIMD
+    //----- vector of values
+
+#ifdef __AVX__
+    typedef double Vector __attribute__(( vector_size( 32 ) ));
+#else
+    typedef double Vector __attribute__(( vector_size( 16 ) ));
+#endif
+    /// Integer lanes of the Vector type (also its masks, with all bits of the lanes fulfilling the condition set)
+    typedef Mask<Vector> Integers;
+
+    template<> inline Vector broadcast<Vector>( double x ) { return x-Vector{}; } // (-0. kept)
+
+    inline double get( const Vector& v, unsigned short i ) { return v[i]; }
+    inline void set( Vector& v, unsigned short i, double val ) { v[i] = val; }
+    inline bool any( const Integers& m ) {
+      for ( unsigned short i=0; i<width<Vector>(); i++ ) if ( m[i] ) return true;
+      return false;
+    }
+    inline Vector select( const Integers& m, const Vector& a, const Vector& b ) { return m ? a : b; }
+    inline Vector abs( const Vector& x ) { return (Vector)( (Integers)x & ~(Integers)broadcast<Vector>( -0. ) ); }
+    inline Vector min( const Vector& a, const Vector& b ) { return ( a < b ) ? a : b; }
+
+    inline Vector
+    sqrt( Vector x )
+    {
+#if defined( __AVX__ )
+      return _mm256_sqrt_pd( x );
+#elif defined( __SSE2__ )
+      return _mm_sqrt_pd( x );
+#else
+      for ( unsigned short i=0; i<width<Vector>(); i++ ) x[i] = std::sqrt( x[i] );
+      return x;
+#endif
+    }
+
+    /// Nearest integer of each lane (for |x| < 2**51), as a double and as an integer
+    inline Vector
+    round( const Vector& x, Integers& n )
+    {
+      const Vector magic = broadcast<Vector>( 6755399441055744. ); // 1.5*2**52: the sum is rounded to an integer, held in the lowest bits
+      const Vector sum = x+magic;
+      n = (Integers)sum-(Integers)magic;
+      return sum-magic;
+    }
+
+    inline Vector
+    exp( const Vector& x )
+    {
+      //--- x = n log(2) + r with |r| <= log(2)/2, then exp(r) from its Taylor expansion (up to r**13)
+      Integers n;
+      const Vector nd = round( x*M_LOG2E, n );
+      const Vector r = ( x-nd*6.93147180369123816490e-01 )-nd*1.90821492927058770002e-10; // log(2), in two parts
+      Vector p = broadcast<Vector>( 1./6227020800. );
+      const double coeffs[] = { 1./479001600., 1./39916800., 1./3628800., 1./362880., 1./40320., 1./5040., 1./720., 1./120., 1./24., 1./6., 0.5, 1., 1. };
+      for ( const auto& c : coeffs ) p = p*r+c;
+      //--- 2**n, in two factors for the extreme values of n to remain representable
+      const Integers h = n >> 1;
+      p *= (Vector)( ( h+1023 ) << 52 );
+      p *= (Vector)( ( n-h+1023 ) << 52 );
+      p = ( x > 709.782712893384 ) ? broadcast<Vector>( std::numeric_limits<double>::infinity() ) : p;
+      return ( x < -745.1332191019411 ) ? broadcast<Vector>( 0. ) : p;
+    }
+
+    inline Vector
+    expm1( const Vector& x )
+    {
+      //--- exp(x)-1 without cancellation for |x| <= log(2)/2, from the Taylor expansion of exp(x) (up to x**13)
+      Vector p = broadcast<Vector>( 1./6227020800. );
+      const double coeffs[] = { 1./479001600., 1./39916800., 1./3628800., 1./362880., 1./40320., 1./5040., 1./720., 1./120., 1./24., 1./6., 0.5, 1. };
+      for ( const auto& c : coeffs ) p = p*x+c;
+      return ( abs( x ) <= 0.5*M_LN2 ) ? p*x : exp( x )-1.;
+    }
+
+    inline Vector
+    log( const Vector& x )
+    {
+      //--- x = 2**e m with m in [sqrt(1/2), sqrt(2)), then log(m) = 2 atanh(s) with s = (m-1)/(m+1),
+      //    from its Taylor expansion (up to s**23)
+      const Integers bits = (Integers)x;
+      Vector m = (Vector)( ( bits & 0x000fffffffffffffl ) | 0x3ff0000000000000l );
+      Integers e = ( ( bits >> 52 ) & 0x7ff )-1023;
+      const Integers high = ( m > M_SQRT2 );
+      m = high ? m*0.5 : m;
+      e -= high; // high lanes are set to -1
+      const Vector s = ( m-1. )/( m+1. ), s2 = s*s;
+      Vector p = broadcast<Vector>( 1./23. );
+      const double coeffs[] = { 1./21., 1./19., 1./17., 1./15., 1./13., 1./11., 1./9., 1./7., 1./5., 1./3., 1. };
+      for ( const auto& c : coeffs ) p = p*s2+c;
+      const Vector magic = broadcast<Vector>( 6755399441055744. );
+      const Vector ed = (Vector)( e+(Integers)magic )-magic;
+      Vector res = ( ed*1.90821492927058770002e-10+2.*s*p )+ed*6.93147180369123816490e-01;
+      //--- special values
+      res = ( x == std::numeric_limits<double>::infinity() ) ? x : res;
+      res = ( x == 0. ) ? broadcast<Vector>( -std::numeric_limits<double>::infinity() ) : res;
+      return ( x < 0. || x != x ) ? broadcast<Vector>( std::numeric_limits<double>::quiet_NaN() ) : res;
+    }
+
+    inline Vector pow( const Vector& x, const Vector& y ) { return exp( y*log( x ) ); }
+
+    inline void
+    sincos( const Vector& x, Vector& s, Vector& c )
+    {
+      //--- x = n pi/2 + r with |r| <= pi/4, then sin(r) and cos(r) from their Taylor expansions (up to r**16)
+      Integers n;
+      const Vector nd = round( x*M_2_PI, n );
+      const Vector r = ( x-nd*1.57079632673412561417e+00 )-nd*6.07710050650619224932e-11; // pi/2, in two parts
+      const Vector r2 = r*r;
+      Vector ps = broadcast<Vector>( -1./1307674368000. ), pc = broadcast<Vector>( 1./20922789888000. );
+      const double coeffs_s[] = { 1./6227020800., -1./39916800., 1./362880., -1./5040., 1./120., -1./6., 1. };
+      const double coeffs_c[] = { -1./87178291200., 1./479001600., -1./3628800., 1./40320., -1./720., 1./24., -0.5, 1. };
+      for ( const auto& cf : coeffs_s ) ps = ps*r2+cf;
+      for ( const auto& cf : coeffs_c ) pc = pc*r2+cf;
+      ps *= r;
+      //--- quadrant of the angle
+      const Integers swap = ( ( n & 1 ) != 0 );
+      s = swap ? pc : ps;
+      c = swap ? ps : pc;
+      s = ( ( n & 2 ) != 0 ) ? -s : s;
+      c = ( ( ( n+1 ) & 2 ) != 0 ) ? -c : c;
+    }
+
+    inline Vector cos( const Vector& x ) { Vector s, c; sincos( x, s, c ); return c; }
+
+    inline Vector
+    atan( const Vector& x )
+    {
+      //--- reduction to |t| <= tan(pi/16), from atan(a) = pi/2-atan(1/a) and atan(a) = 2 atan(a/(1+sqrt(1+a**2))),
+      //    then atan(t) from its Taylor expansion (up to t**25)
+      const Vector a = abs( x );
+      const Integers inv = ( a > 1. );
+      Vector t = inv ? 1./a : a;
+      t = t/( 1.+sqrt( 1.+t*t ) );
+      t = t/( 1.+sqrt( 1.+t*t ) );
+      const Vector t2 = t*t;
+      Vector p = broadcast<Vector>( 1./25. );
+      const double coeffs[] = { -1./23., 1./21., -1./19., 1./17., -1./15., 1./13., -1./11., 1./9., -1./7., 1./5., -1./3., 1. };
+      for ( const auto& c : coeffs ) p = p*t2+c;
+      Vector res = 4.*t*p;
+      res = inv ? M_PI_2-res : res;
+      return ( x < 0. ) ? -res : res;
+    }
+
+    inline Vector
+    atan2( const Vector& y, const Vector& x )
+    {
+      Vector res = atan( y/x );
+      res = ( x < 0. ) ? res+( ( y < 0. ) ? broadcast<Vector>( -M_PI ) : broadcast<Vector>( M_PI ) ) : res;
+      return ( x == 0. && y == 0. ) ? broadcast<Vector>( 0. ) : res;
+    }
+#else
+    typedef double Vector;
+#endif
+  }
+}
+
+#endif
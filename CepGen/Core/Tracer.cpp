@@ -0,0 +1,130 @@
+#include "CepGen/Core/Tracer.h"
+#include "CepGen/Core/Exception.h"
+#include "CepGen/Core/utils.h"
+
+#include <unistd.h>
+
+namespace CepGen
+{
+  std::atomic<bool> Tracer::enabled_( false );
+
+  Tracer&
+  Tracer::get()
+  {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  bool
+  Tracer::enable( unsigned int capacity )
+  {
+    if ( capacity == 0 ) {
+      throw Exception( __PRETTY_FUNCTION__, "Invalid capacity for the timeline trace!", JustWarning );
+    }
+    std::lock_guard<std::mutex> lock( mutex_ );
+    if ( enabled() ) return false;
+    capacity_ = capacity;
+    epoch_ = clock::now();
+    //--- forget about the previous records, and the threads terminated in the meantime
+    for ( auto it=threads_.begin(); it!=threads_.end(); ) {
+      if ( it->use_count() == 1 ) { it = threads_.erase( it ); continue; }
+      std::lock_guard<std::mutex> thr_lock( ( *it )->mutex );
+      ( *it )->records.clear();
+      ( *it )->num_records = 0;
+      ++it;
+    }
+    enabled_ = true;
+    Debugging( Form( "Timeline trace enabled with %d regions per thread", capacity ) );
+    return true;
+  }
+
+  void
+  Tracer::disable()
+  {
+    enabled_ = false;
+  }
+
+  Tracer::Session::Session( const std::string& file, unsigned int capacity )
+  {
+    if ( !file.empty() && get().enable( capacity ) ) file_ = file;
+  }
+
+  Tracer::Session::~Session()
+  {
+    if ( file_.empty() ) return;
+    get().disable();
+    try { get().write( file_ ); } catch ( Exception& e ) { e.dump(); }
+  }
+
+  Tracer::ThreadRecords&
+  Tracer::threadRecords()
+  {
+    thread_local std::shared_ptr<ThreadRecords> records;
+    if ( !records ) {
+      records = std::make_shared<ThreadRecords>();
+      records->num_records = 0;
+      Tracer& tracer = get();
+      std::lock_guard<std::mutex> lock( tracer.mutex_ );
+      records->id = ++tracer.num_threads_;
+      tracer.threads_.emplace_back( records );
+    }
+    return *records;
+  }
+
+  void
+  Tracer::setThreadName( const char* name )
+  {
+    if ( !enabled() ) return;
+    ThreadRecords& thr = threadRecords();
+    std::lock_guard<std::mutex> lock( thr.mutex );
+    thr.name = name;
+  }
+
+  void
+  Tracer::record( const char* name, const clock::time_point& start, const clock::time_point& end )
+  {
+    Tracer& tracer = get();
+    ThreadRecords& thr = threadRecords();
+    const Record rec = {
+      name,
+      std::chrono::duration_cast<std::chrono::nanoseconds>( start-tracer.epoch_ ).count(),
+      std::chrono::duration_cast<std::chrono::nanoseconds>( end-start ).count()
+    };
+    std::lock_guard<std::mutex> lock( thr.mutex );
+    //--- once the buffer is full, the oldest region is overwritten
+    if ( thr.records.size() < tracer.capacity_ ) thr.records.emplace_back( rec );
+    else thr.records[thr.num_records % thr.records.size()] = rec;
+    thr.num_records++;
+  }
+
+  void
+  Tracer::write( const std::string& file )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    const int pid = getpid();
+    unsigned long long num_dropped = 0;
+    const bool written = writeAtomically( file, [&]( std::ostream& out ) {
+      out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n"
+          << Form( "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"CepGen\"}}", pid );
+      for ( const auto& thr : threads_ ) {
+        std::lock_guard<std::mutex> thr_lock( thr->mutex );
+        const std::string name = thr->name.empty() ? Form( "thread %d", thr->id ) : thr->name;
+        out << ",\n" << Form( "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": \"%s\"}}", pid, thr->id, name.c_str() );
+        //--- oldest regions first
+        const size_t size = thr->records.size(), first = ( thr->num_records > size ) ? thr->num_records % size : 0;
+        for ( size_t i=0; i<size; i++ ) {
+          const Record& rec = thr->records[( first+i ) % size];
+          out << ",\n" << Form( "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+            rec.name, pid, thr->id, rec.start*1.e-3, rec.duration*1.e-3 );
+        }
+        num_dropped += thr->num_records-size;
+      }
+      out << "\n], \"otherData\": {\"dropped_regions\": " << num_dropped << "}}\n";
+    } );
+    if ( !written ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Failed to write the timeline trace \"%s\"", file.c_str() ), JustWarning );
+    }
+    Information( Form( "Timeline trace written in \"%s\"%s", file.c_str(),
+                       ( num_dropped > 0 ) ? Form( " (%llu oldest regions dropped)", num_dropped ).c_str() : "" ) );
+  }
+}
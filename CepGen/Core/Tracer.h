@@ -0,0 +1,119 @@
+#ifndef CepGen_Core_Tracer_h
+#define CepGen_Core_Tracer_h
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+#define TracerConcat_( a, b ) a ## b
+#define TracerConcat( a, b ) TracerConcat_( a, b )
+/// Record the remainder of the current scope in the timeline trace, under a given name (a string literal)
+#define TraceRegion( name ) \
+  CepGen::Tracer::Scope TracerConcat( tracer_scope_, __LINE__ )( name )
+
+namespace CepGen
+{
+  /**
+   * Timeline of the stages of a run (integration iterations, grid preparation,
+   * unweighting trials, events materialisation and export, waits in the
+   * production pipeline), recorded per thread for a later inspection in the
+   * Chrome trace viewer (chrome://tracing) or Perfetto (ui.perfetto.dev).
+   * Each thread records its regions into a ring buffer of its own, holding
+   * the latest ones only. When the tracing is disabled, the cost of a region
+   * reduces to the check of a flag.
+   * \date Oct 2026
+   */
+  class Tracer
+  {
+    public:
+      /// Retrieve the running instance of the tracer
+      static Tracer& get();
+      /// Are the regions currently recorded?
+      static bool enabled() { return enabled_.load( std::memory_order_relaxed ); }
+
+      /// Start recording the regions (previous records are discarded)
+      /// \param[in] capacity Maximal number of regions kept for each thread
+      /// \return false if the regions were already recorded (the current recording is then left untouched)
+      bool enable( unsigned int capacity );
+      /// Stop recording the regions (the records are kept until the next enable call)
+      void disable();
+      /// Name the current thread in the timeline
+      void setThreadName( const char* name );
+      /// Write the timeline in the Chrome trace-event (JSON) format
+      /// \note The file is written under a temporary name, then renamed
+      void write( const std::string& file );
+
+      /**
+       * Recording of the timeline of a run. As the tracer is shared by the whole
+       * process, only the outermost session (e.g. a cocktail, a scan, or a single
+       * run) enables the recording, and writes the timeline once it is over. The
+       * sessions opened in the meantime (e.g. by the runs of a cocktail's channels)
+       * leave the recording untouched.
+       */
+      class Session
+      {
+        public:
+          /// Open a session
+          /// \param[in] file Path to the timeline file (empty to disable)
+          /// \param[in] capacity Maximal number of regions kept for each thread
+          Session( const std::string& file, unsigned int capacity );
+          /// Close the session, and write the timeline if this session enabled its recording
+          ~Session();
+          /// Is this session the one recording the timeline?
+          bool recording() const { return !file_.empty(); }
+
+        private:
+          std::string file_;
+      };
+
+      /// Record the time spent between its construction and its destruction
+      class Scope
+      {
+        public:
+          explicit Scope( const char* name ) : name_( enabled() ? name : nullptr ) { if ( name_ ) start_ = clock::now(); }
+          ~Scope() { if ( name_ ) Tracer::record( name_, start_, clock::now() ); }
+
+        private:
+          const char* name_;
+          std::chrono::steady_clock::time_point start_;
+      };
+
+    private:
+      typedef std::chrono::steady_clock clock;
+      Tracer() : capacity_( 0 ), num_threads_( 0 ) {}
+
+      /// One region recorded
+      struct Record
+      {
+        const char* name;
+        long long start, duration; ///< in ns
+      };
+      /// Ring buffer of the regions recorded by one thread
+      struct ThreadRecords
+      {
+        std::mutex mutex;
+        unsigned int id;
+        std::string name;
+        std::vector<Record> records;
+        /// Total number of regions recorded (possibly exceeding the buffer capacity)
+        unsigned long long num_records;
+      };
+      /// Add one region to the current thread's timeline
+      static void record( const char* name, const clock::time_point& start, const clock::time_point& end );
+      /// Timeline of the current thread
+      static ThreadRecords& threadRecords();
+
+      static std::atomic<bool> enabled_;
+      std::mutex mutex_;
+      clock::time_point epoch_;
+      unsigned int capacity_;
+      unsigned int num_threads_;
+      /// Timelines of all threads which ever entered a region
+      std::vector<std::shared_ptr<ThreadRecords> > threads_;
+  };
+}
+
+#endif
@@ -1,39 +1,46 @@
 #include "Vegas.h"
+#include "CepGen/Core/Profiler.h"
+#include "CepGen/Core/Tracer.h"
+#include "CepGen/Core/Timer.h"
 
 namespace CepGen
 {
-  Vegas::Vegas( const unsigned int dim, double f_( double*, size_t, void* ), Parameters* param ) :
-    vegas_bin_( 0 ), correc_( 0. ), correc2_( 0. ),
-    input_params_( param ),
-    grid_prepared_( false ), gen_prepared_( false ),
+  Vegas::Vegas( const unsigned int dim, double f_( double*, size_t, void* ), Parameters* param, IntegrandContext* ctx ) :
+    vegas_bin_( 0 ), correcting_( false ), correc_( 0. ), correc2_( 0. ),
+    input_params_( param ), context_( ctx ),
+    warm_start_( false ), gen_prepared_( false ),
     f_max2_( 0. ), f_max_diff_( 0. ), f_max_old_( 0. ), f_max_global_( 0. ),
-    function_( std::unique_ptr<gsl_monte_function>( new gsl_monte_function ) )
+    refined_bin_( -1 ), refine_left_( 0 ), refine_max_( 0. ),
+    function_( std::unique_ptr<gsl_monte_function>( new gsl_monte_function ) ),
+    rng_( param->vegas.seed, param->vegas.stream )
   {
     //--- function to be integrated
     function_->f = f_;
     function_->dim = dim;
-    function_->params = (void*)param;
+    function_->params = (void*)ctx;
     num_converg_ = param->vegas.ncvg;
     num_iter_ = param->vegas.itvg;
 
-    //--- initialise the random number generator
-    gsl_rng_env_setup();
-    rng_ = gsl_rng_alloc( gsl_rng_default );
-    gsl_rng_set( rng_, time( nullptr ) ); // seed with time
+    //--- interface the random number generator to GSL
+    gsl_engine_ = RandomGenerator::gslEngine( &rng_ );
 
     Debugging( Form( "Number of integration dimensions: %d\n\t"
                      "Number of iterations:             %d\n\t"
-                     "Number of function calls:         %d", dim, num_iter_, num_converg_ ) );
+                     "Number of function calls:         %d\n\t"
+                     "Random generator seed:            %llu", dim, num_iter_, num_converg_, rng_.seed() ) );
   }
 
   Vegas::~Vegas()
   {
-    if ( rng_ ) gsl_rng_free( rng_ );
+    if ( gsl_engine_ ) gsl_rng_free( gsl_engine_ );
   }
 
   int
   Vegas::integrate( double& result, double& abserr )
   {
+    Timer tmr;
+    const unsigned long long num_calls = context_->num_calls;
+
     //--- prepare Vegas
     gsl_monte_vegas_state* state = gsl_monte_vegas_alloc( function_->dim );
 
@@ -41,18 +48,56 @@ namespace CepGen
     std::vector<double> x_low( function_->dim, 0. ), x_up( function_->dim, 1. );
 
     //--- launch Vegas
-    int veg_res;
-
-    //----- warmup (prepare the grid)
-    if ( !grid_prepared_ ) {
-      veg_res = gsl_monte_vegas_integrate( function_.get(), &x_low[0], &x_up[0], function_->dim, 10000, rng_, state, &result, &abserr );
-      grid_prepared_ = true;
+    int veg_res = 0;
+
+    //----- restart from the grid given through setGrid, only discarding its previous results
+    if ( warm_start_ ) {
+      state->bins = grid_.bins;
+      std::copy( grid_.xi.begin(), grid_.xi.end(), state->xi );
+      state->vol = 1.;
+      for ( unsigned int j=0; j<function_->dim; j++ ) state->delx[j] = x_up[j]-x_low[j];
+      state->stage = 1;
+      warm_start_ = false;
     }
+    //----- or warmup (prepare a fresh grid, whatever was integrated before)
+    else {
+      grid_ = Grid();
+      veg_res = gsl_monte_vegas_integrate( function_.get(), &x_low[0], &x_up[0], function_->dim, 10000, gsl_engine_, state, &result, &abserr );
+    }
+    //----- histograms filled along the integration iterations (the event kinematics is then computed for each point)
+    histograms_ = input_params_->histograms;
+    for ( auto& hist : histograms_ ) hist.reset();
+    HistogramsFiller filler = { this, state, 0., 0., 0 };
+    gsl_monte_function hist_function = { &Vegas::fillHistograms, function_->dim, (void*)&filler };
+    gsl_monte_function* integrand = ( histograms_.empty() ) ? function_.get() : &hist_function;
+    context_->kinematics = !histograms_.empty();
+
     //----- integration
+    const double precision = input_params_->vegas.precision;
+    stats_.num_iterations = 0;
     for ( unsigned int i=0; i<num_iter_; i++ ) {
-      veg_res = gsl_monte_vegas_integrate( function_.get(), &x_low[0], &x_up[0], function_->dim, 0.2*num_converg_, rng_, state, &result, &abserr );
+      TraceRegion( "integration iteration" );
+      stats_.num_iterations++;
+      filler.sum = filler.sum2 = 0.;
+      filler.num_calls = 0;
+      veg_res = gsl_monte_vegas_integrate( integrand, &x_low[0], &x_up[0], function_->dim, 0.2*num_converg_, gsl_engine_, state, &result, &abserr );
       PrintMessage( Form( ">> Iteration %2d: average = %10.6f   sigma = %10.6f   chi2 = %4.3f", i+1, result, abserr, gsl_monte_vegas_chisq( state ) ) );
+      //--- the iterations are weighted by the inverse of the variance of their integral estimate, as in the integrator
+      if ( filler.num_calls > 1 ) {
+        const double mean = filler.sum/filler.num_calls, var = ( filler.sum2/filler.num_calls-mean*mean )/( filler.num_calls-1 );
+        for ( auto& hist : histograms_ ) hist.endIteration( filler.num_calls, ( var > 0. ) ? 1./var : 1. );
+      }
+      if ( precision > 0. && abserr < precision*fabs( result ) ) break;
     }
+    context_->kinematics = false;
+
+    //--- keep the adapted grid for a later integration
+    grid_.bins = state->bins;
+    grid_.xi.assign( state->xi, state->xi+( state->bins+1 )*function_->dim );
+
+    stats_.chi2 = gsl_monte_vegas_chisq( state );
+    stats_.integration_calls += context_->num_calls-num_calls;
+    stats_.integration_time += tmr.elapsed();
 
     //--- clean Vegas
     gsl_monte_vegas_free( state );
@@ -60,6 +105,54 @@ namespace CepGen
     return veg_res;
   }
 
+  double
+  Vegas::fillHistograms( double* x, size_t ndim, void* params )
+  {
+    HistogramsFiller* filler = static_cast<HistogramsFiller*>( params );
+    Vegas* veg = filler->vegas;
+    const double value = veg->function_->f( x, ndim, veg->function_->params );
+
+    //--- inverse of the sampling density: product of the widths of the grid bins holding the point
+    const gsl_monte_vegas_state* state = filler->state;
+    const unsigned int bins = state->bins;
+    double jac = 1.;
+    for ( size_t j=0; j<ndim; j++ ) {
+      unsigned int low = 0, high = bins;
+      while ( high-low > 1 ) {
+        const unsigned int mid = ( low+high )/2;
+        if ( x[j] < state->xi[mid*ndim+j] ) high = mid;
+        else low = mid;
+      }
+      jac *= bins*( state->xi[high*ndim+j]-state->xi[low*ndim+j] );
+    }
+    const double weight = value*jac;
+    filler->sum += weight;
+    filler->sum2 += weight*weight;
+    filler->num_calls++;
+    if ( weight > 0. ) {
+      Event& ev = *veg->context_->process->event();
+      for ( auto& hist : veg->histograms_ ) hist.fill( ev, weight );
+    }
+    return value;
+  }
+
+  void
+  Vegas::setGrid( const Grid& grid )
+  {
+    if ( grid.bins == 0 || grid.xi.size() != ( grid.bins+1 )*function_->dim ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Invalid integration grid for a %d-dimensional integration!", function_->dim ), FatalError );
+    }
+    grid_ = grid;
+    warm_start_ = true;
+  }
+
+  void
+  Vegas::restoreGrid( const Grid& grid )
+  {
+    setGrid( grid );
+    warm_start_ = false;
+  }
+
   void
   Vegas::generate()
   {
@@ -75,23 +168,48 @@ namespace CepGen
       if ( generateOneEvent() ) i++;
     }
     Information( Form( "%d events generated", i ) );
+    Profiler::get().summary( "events generation" );
   }
 
   bool
   Vegas::generateOneEvent()
+  {
+    std::vector<double> x( function_->dim, 0. );
+    if ( !sample( x ) ) return false;
+    return storeEvent( x );
+  }
+
+  bool
+  Vegas::sample( std::vector<double>& x )
   {
     if ( !gen_prepared_ ) setGen();
 
-    const unsigned int ndim = function_->dim, max = pow( mbin_, ndim );
+    Timer tmr;
+    const unsigned long long num_calls = context_->num_calls;
+    bool accepted = false;
+    { TraceRegion( "event sampling" ); accepted = samplePoint( x ); }
+    stats_.sampling_calls += context_->num_calls-num_calls;
+    stats_.sampling_time += tmr.elapsed();
+    if ( accepted ) stats_.num_sampled++;
+    return accepted;
+  }
 
-    std::vector<double> x( ndim, 0. );
+  bool
+  Vegas::samplePoint( std::vector<double>& x )
+  {
+
+    const unsigned int max = pow( mbin_, function_->dim );
+
+    //--- improve the estimate of the cells maxima
+    refineCells();
 
     //--- correction cycles
     
-    if ( vegas_bin_ != 0 ) {
+    if ( correcting_ ) {
       bool has_correction = false;
       while ( !correctionCycle( x, has_correction ) ) {}
-      if ( has_correction ) return storeEvent( x );
+      if ( has_correction ) return true;
+      correcting_ = false;
     }
 
     double weight;
@@ -101,6 +219,7 @@ namespace CepGen
 
     //----- select a Vegas bin and reject if fmax is too small
     do {
+      TraceRegion( "generation trial" );
       do {
         // ...
         vegas_bin_ = uniform() * max;
@@ -108,39 +227,33 @@ namespace CepGen
         nm_[vegas_bin_] += 1;
       } while ( y > f_max_[vegas_bin_] );
       // Select x values in this Vegas bin
-      int jj = vegas_bin_;
-      for ( unsigned int i=0; i<ndim; i++ ) {
-        int jjj = jj / mbin_;
-        n_[i] = jj - jjj * mbin_;
-        x[i] = ( uniform() + n_[i] ) / mbin_;
-        jj = jjj;
-      }
+      binCoordinates( vegas_bin_, n_ );
+      shootInBin( x, n_ );
 
       // Get weight for selected x value
       weight = F( x );
     } while ( y > weight );
 
-    if ( weight <= f_max_[vegas_bin_] ) vegas_bin_ = 0;
     // Init correction cycle if weight is higher than fmax or ffmax
-    else if ( weight <= f_max_global_ ) {
-      f_max_old_ = f_max_[vegas_bin_];
-      f_max_[vegas_bin_] = weight;
-      f_max_diff_ = weight-f_max_old_;
-      correc_ = ( nm_[vegas_bin_] - 1. ) * f_max_diff_ / f_max_global_ - 1.;
-    }
-    else {
+    correcting_ = ( weight > f_max_[vegas_bin_] );
+    if ( correcting_ ) {
+      overshoots_[vegas_bin_]++;
       f_max_old_ = f_max_[vegas_bin_];
       f_max_[vegas_bin_] = weight;
       f_max_diff_ = weight-f_max_old_;
-      f_max_global_ = weight;
-      correc_ = ( nm_[vegas_bin_] - 1. ) * f_max_diff_ / f_max_global_ * weight / f_max_global_ - 1.;
+      if ( weight <= f_max_global_ ) {
+        correc_ = ( nm_[vegas_bin_] - 1. ) * f_max_diff_ / f_max_global_ - 1.;
+      }
+      else {
+        f_max_global_ = weight;
+        correc_ = ( nm_[vegas_bin_] - 1. ) * f_max_diff_ / f_max_global_ * weight / f_max_global_ - 1.;
+      }
     }
 
     Debugging( Form( "Correction applied: %f, Vegas bin = %d", correc_, vegas_bin_ ) );
 
     // Return with an accepted event
-    if ( weight > 0. ) return storeEvent( x );
-    return false;
+    return ( weight > 0. );
   }
 
   bool
@@ -159,13 +272,12 @@ namespace CepGen
       correc_ = -1.;
       std::vector<double> xtmp( ndim, 0. );
       // Select x values in Vegas bin
-      for ( unsigned int k=0; k<ndim; k++ ) {
-        xtmp[k] = ( uniform() + n_[k] ) * inv_mbin_;
-      }
+      shootInBin( xtmp, n_ );
       // Compute weight for x value
       weight = F( xtmp );
       // Parameter for correction of correction
       if ( weight > f_max_[vegas_bin_] ) {
+        overshoots_[vegas_bin_]++;
         if ( weight > f_max2_ ) f_max2_ = weight;
         correc2_ -= 1.;
         correc_ += 1.;
@@ -200,13 +312,124 @@ namespace CepGen
     return true;
   }
 
+  Vegas::GenerationState
+  Vegas::generationState()
+  {
+    if ( !gen_prepared_ ) setGen();
+
+    GenerationState state;
+    state.f_max = f_max_;
+    state.nm = nm_;
+    state.n = n_;
+    state.vegas_bin = vegas_bin_;
+    state.correcting = correcting_;
+    state.correc = correc_;
+    state.correc2 = correc2_;
+    state.f_max2 = f_max2_;
+    state.f_max_diff = f_max_diff_;
+    state.f_max_old = f_max_old_;
+    state.f_max_global = f_max_global_;
+    state.overshoots = overshoots_;
+    state.refined_bin = refined_bin_;
+    state.refine_left = refine_left_;
+    state.refine_max = refine_max_;
+    state.rng_position = rng_.position();
+    return state;
+  }
+
+  void
+  Vegas::restoreGenerationState( const GenerationState& state )
+  {
+    const unsigned int ndim = function_->dim, max = pow( mbin_, ndim );
+    if ( state.f_max.size() != max || state.nm.size() != max || state.overshoots.size() != max || state.n.size() != ndim ) {
+      throw Exception( __PRETTY_FUNCTION__, Form( "Generation state is not compatible with a %d-dimensional grid!", ndim ), FatalError );
+    }
+    f_max_ = state.f_max;
+    nm_ = state.nm;
+    n_ = state.n;
+    vegas_bin_ = state.vegas_bin;
+    correcting_ = state.correcting;
+    correc_ = state.correc;
+    correc2_ = state.correc2;
+    f_max2_ = state.f_max2;
+    f_max_diff_ = state.f_max_diff;
+    f_max_old_ = state.f_max_old;
+    f_max_global_ = state.f_max_global;
+    overshoots_ = state.overshoots;
+    refined_bin_ = state.refined_bin;
+    refine_left_ = state.refine_left;
+    refine_max_ = state.refine_max;
+    rng_.seek( state.rng_position );
+    gen_prepared_ = true;
+  }
+
+  void
+  Vegas::shootInBin( std::vector<double>& x, const std::vector<int>& n )
+  {
+    rng_.fill( &x[0], x.size() );
+    for ( unsigned int k=0; k<x.size(); k++ ) x[k] = ( x[k] + n[k] ) * inv_mbin_;
+  }
+
+  void
+  Vegas::binCoordinates( int bin, std::vector<int>& n ) const
+  {
+    for ( unsigned int k=0; k<n.size(); k++ ) {
+      const int jj = bin / mbin_;
+      n[k] = bin - jj * mbin_;
+      bin = jj;
+    }
+  }
+
+  void
+  Vegas::refineCells()
+  {
+    //--- refinement disabled, or a correction cycle is ongoing
+    if ( input_params_->vegas.refine_npoints == 0 || correcting_ ) return;
+
+    //--- start with the cell whose maximum was most often exceeded
+    if ( refined_bin_ < 0 ) {
+      const std::vector<unsigned int>::const_iterator worst = std::max_element( overshoots_.begin(), overshoots_.end() );
+      if ( worst == overshoots_.end() || *worst == 0 ) return;
+      refined_bin_ = worst-overshoots_.begin();
+      refine_left_ = input_params_->vegas.refine_npoints;
+      refine_max_ = 0.;
+    }
+
+    const unsigned int ndim = function_->dim;
+    std::vector<int> n( ndim, 0 );
+    binCoordinates( refined_bin_, n );
+    std::vector<double> x( ndim, 0. );
+    for ( unsigned short i=0; i<refine_points_per_event_ && refine_left_>0; i++, refine_left_-- ) {
+      shootInBin( x, n );
+      refine_max_ = std::max( refine_max_, F( x ) );
+    }
+    if ( refine_left_ > 0 ) return;
+
+    //--- all points probed; raise the maximum, and correct for the events
+    //    already generated in this cell with the former maximum
+    const int bin = refined_bin_;
+    Debugging( Form( "Cell %d refined with %d points (exceeded %d times): maximum %g -> %g",
+                     bin, input_params_->vegas.refine_npoints, overshoots_[bin], f_max_[bin], std::max( f_max_[bin], refine_max_ ) ) );
+    overshoots_[bin] = 0;
+    refined_bin_ = -1;
+    if ( refine_max_ <= f_max_[bin] ) return;
+
+    f_max_old_ = f_max_[bin];
+    f_max_[bin] = refine_max_;
+    f_max_diff_ = refine_max_-f_max_old_;
+    f_max_global_ = std::max( f_max_global_, refine_max_ );
+    correc_ = nm_[bin] * f_max_diff_ / f_max_global_;
+    vegas_bin_ = bin;
+    correcting_ = true;
+    n_ = n;
+  }
+
   bool
   Vegas::storeEvent( const std::vector<double>& x )
   {
-    input_params_->setStorage( true );
-    F( x );
+    materialise( x, context_ );
+    input_params_->generation.last_event = context_->process->event();
     input_params_->generation.ngen += 1;
-    input_params_->setStorage( false );
     if ( input_params_->generation.ngen % input_params_->generation.gen_print_every == 0 ) {
       Debugging( Form( "Generated events: %d", input_params_->generation.ngen ) );
       input_params_->generation.last_event->dump();
@@ -214,10 +437,22 @@ namespace CepGen
     return true;
   }
 
+  void
+  Vegas::materialise( const std::vector<double>& x, IntegrandContext* ctx )
+  {
+    TraceRegion( "event fill" );
+    ctx->storage = true;
+    F( x, ctx );
+    ctx->storage = false;
+  }
+
   void
   Vegas::setGen()
   {
     Information( Form( "Preparing the grid for the generation of unweighted events: %d points", input_params_->vegas.npoints ) );
+    TraceRegion( "grid preparation" );
+    Timer tmr;
+    const unsigned long long num_calls = context_->num_calls;
     // Variables for debugging
     std::ostringstream os;
     if ( Logger::get().level >= Logger::Debug ) {
@@ -235,6 +470,8 @@ namespace CepGen
 
     nm_ = std::vector<int>( max, 0 );
     f_max_ = std::vector<double>( max, 0. );
+    overshoots_ = std::vector<unsigned int>( max, 0 );
+    refined_bin_ = -1;
     n_ = std::vector<int>( ndim, 0 );
 
     std::vector<double> x( ndim, 0. );
@@ -246,17 +483,11 @@ namespace CepGen
 
     //--- main loop
     for ( unsigned int i=0; i<max; i++ ) {
-      int jj = i;
-      for ( unsigned int j=0; j<ndim; j++ ) {
-        int jjj = jj*inv_mbin_;
-        n_[j] = jj-jjj*mbin_;
-        jj = jjj;
-      }
+      TraceRegion( "grid cell" );
+      binCoordinates( i, n_ );
       double fsum = 0., fsum2 = 0.;
       for ( unsigned int j=0; j<npoin; j++ ) {
-        for ( unsigned int k=0; k<ndim; k++ ) {
-          x[k] = ( uniform() + n_[k] ) * inv_mbin_;
-        }
+        shootInBin( x, n_ );
         const double z = F( x );
         f_max_[i] = std::max( f_max_[i], z );
         fsum += z;
@@ -286,6 +517,10 @@ namespace CepGen
     sum2 = sum2/max;
     sum2p = sum2p/max;
 
+    stats_.grid_calls += context_->num_calls-num_calls;
+    stats_.grid_time += tmr.elapsed();
+    stats_.grid_efficiency = ( f_max_global_ > 0. ) ? sum/f_max_global_ : 0.;
+
     if ( Logger::get().level >= Logger::Debug ) {
       const double sig = sqrt( sum2-sum*sum ), sigp = sqrt( sum2p );
 
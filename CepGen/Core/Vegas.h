@@ -2,13 +2,15 @@
 #define CepGen_Core_Vegas_h
 
 #include <fstream>
-#include <cstdio> // remove (DEBUG)
 #include <gsl/gsl_monte_vegas.h>
 #include <gsl/gsl_rng.h>
 
 #include "CepGen/Parameters.h"
+#include "CepGen/Core/IntegrandContext.h"
+#include "CepGen/Core/RandomGenerator.h"
 
 #include <vector>
+#include <algorithm>
 
 #define fMaxNbins 50
 #define ONE 1.
@@ -21,14 +23,75 @@ namespace CepGen
    */
   class Vegas {
     public:
+      /// Snapshot of the unweighted events generation state, to be restored when resuming a run
+      struct GenerationState
+      {
+        /// Maximal function value in each cell of the generation grid
+        std::vector<double> f_max;
+        /// Number of times each cell was selected
+        std::vector<int> nm;
+        /// Coordinates of the cell under correction
+        std::vector<int> n;
+        /// Index of the cell under correction
+        int vegas_bin;
+        /// Is a correction cycle running in this cell?
+        bool correcting;
+        double correc, correc2, f_max2, f_max_diff, f_max_old;
+        /// Maximal function value over the whole phase space
+        double f_max_global;
+        /// Number of times the maximum of each cell was exceeded
+        std::vector<unsigned int> overshoots;
+        /// Cell being refined (-1 if none)
+        int refined_bin;
+        /// Number of points left to shoot in the cell being refined
+        unsigned int refine_left;
+        /// Maximal function value found so far in the cell being refined
+        double refine_max;
+        /// Position in the integrator's random numbers stream
+        unsigned long long rng_position;
+      };
+      /// Integration grid adapted to the function, to be reused as the starting point of another integration
+      struct Grid
+      {
+        Grid() : bins( 0 ) {}
+        /// Number of bins along each dimension (0 if the grid is not yet adapted)
+        unsigned int bins;
+        /// Bins boundaries, (bins+1)*dimensions values (the dimension index running fastest)
+        std::vector<double> xi;
+      };
+      /// Counters and timings of the integration, generation grid preparation, and unweighting steps
+      struct Statistics
+      {
+        Statistics() : num_iterations( 0 ), chi2( 0. ), integration_calls( 0 ), integration_time( 0. ),
+                       grid_calls( 0 ), grid_time( 0. ), grid_efficiency( 0. ),
+                       num_sampled( 0 ), sampling_calls( 0 ), sampling_time( 0. ) {}
+        /// Number of iterations performed in the last integration (warm-up excluded)
+        unsigned int num_iterations;
+        /// \f$\chi^2\f$ per degree of freedom of the last integration iterations
+        double chi2;
+        /// Number of function calls, and time (in s) spent in the integrations
+        unsigned long long integration_calls;
+        double integration_time;
+        /// Number of function calls, and time (in s) spent in the generation grid preparation
+        unsigned long long grid_calls;
+        double grid_time;
+        /// Unweighting efficiency expected from the generation grid (mean over maximal function value)
+        double grid_efficiency;
+        /// Number of points accepted by the unweighting
+        unsigned long long num_sampled;
+        /// Number of function calls, and time (in s) spent to sample the unweighted points
+        unsigned long long sampling_calls;
+        double sampling_time;
+      };
       /**
        * Book the memory slots and structures for the Vegas integrator
        * \note This code is based on the Vegas Monte Carlo integration algorithm developed by P. Lepage, as documented in @cite PeterLepage1978192
        * \param[in] dim_ Number of dimensions on which the function will be integrated
        * \param[in] f_ Function to be integrated
        * \param[inout] inParam_ Run parameters to define the phase space on which this integration is performed (embedded in an Parameters object)
+       * \param[inout] ctx_ Context in which the function is evaluated
        */
-      Vegas( const unsigned int dim_, double f_(double*,size_t,void*), Parameters* inParam_ );
+      Vegas( const unsigned int dim_, double f_(double*,size_t,void*), Parameters* inParam_, IntegrandContext* ctx_ );
       /// Class destructor
       ~Vegas();
       /**
@@ -40,6 +103,20 @@ namespace CepGen
        * \return 0 if the integration was performed successfully
        */
       int integrate( double& result_,double& abserr_ );
+      /// Grid adapted to the function in the last integration
+      const Grid& grid() const { return grid_; }
+      /**
+       * Start the next integration from a grid already adapted to a close function (e.g. for
+       * a neighbouring phase space), instead of a flat grid with a full warm-up
+       * \param[in] grid Grid obtained from the integration of the close function
+       */
+      void setGrid( const Grid& grid );
+      /// Set the grid adapted at an earlier integration of the same function (e.g. retrieved from a cache), without starting the next integration from it
+      void restoreGrid( const Grid& grid );
+      /// Differential cross sections filled during the last integration (see Parameters::histograms)
+      const std::vector<Histogram>& histograms() const { return histograms_; }
+      /// Counters and timings of all steps performed by this instance
+      const Statistics& statistics() const { return stats_; }
       /// Launch the generation of events
       void generate();
       /**
@@ -48,22 +125,58 @@ namespace CepGen
        * \return A boolean stating if the generation was successful (in term of the computed weight for the phase space point)
        */
       bool generateOneEvent();
+      /**
+       * Pick one phase space point according to the unweighting procedure (including
+       * the correction cycles), without computing the full event kinematics
+       * \param[out] x The point selected
+       * \return A boolean stating whether a point was accepted
+       */
+      bool sample( std::vector<double>& x );
+      /**
+       * Compute the full event kinematics for a phase space point
+       * \param[in] x The point to be materialised as an event
+       * \param[inout] ctx Context (and process) to be used for the computation; the event is stored in its process
+       */
+      void materialise( const std::vector<double>& x, IntegrandContext* ctx );
       const unsigned short dimensions() const { return ( !function_ ) ? 0 : function_->dim; }
+      /// Random numbers generator used for the integration and the events generation
+      RandomGenerator& randomGenerator() { return rng_; }
+      /// Retrieve the current state of the events generation (the generation grid is prepared if needed)
+      GenerationState generationState();
+      /// Restore a previous state of the events generation, bypassing the grid preparation
+      void restoreGenerationState( const GenerationState& state );
     private:
+      /// Sums over the points of the current integration iteration, for the histograms filling
+      struct HistogramsFiller
+      {
+        Vegas* vegas;
+        /// Integrator state, holding the grid from which the points are sampled
+        const gsl_monte_vegas_state* state;
+        /// Sum of the weights (and of their squares) of all points sampled
+        double sum, sum2;
+        /// Number of points sampled
+        unsigned long num_calls;
+      };
+      /**
+       * Evaluate the function to be integrated, and fill the histograms with its value
+       * times the inverse of the sampling density of the Vegas grid at this point
+       * \param[in] params Histograms filler (see HistogramsFiller)
+       */
+      static double fillHistograms( double* x, size_t ndim, void* params );
       /**
-       * Evaluate the function to be integrated at a point @a x_, using the default Parameters object @a fInputParameters
+       * Evaluate the function to be integrated at a point @a x_, in the default evaluation context
        * \param[in] x_ The point at which the function is to be evaluated
        * \return Function value at this point @a x_
        */
-      inline double F( const std::vector<double>& x ) { return F( x, input_params_ ); }
+      inline double F( const std::vector<double>& x ) { return F( x, context_ ); }
       /**
-       * Evaluate the function to be integrated at a point @a x_, given a set of Parameters @a ip_
+       * Evaluate the function to be integrated at a point @a x_, in a given evaluation context @a ctx
        * \param[in] x_ The point at which the function is to be evaluated
-       * \param[in] ip_ A set of parameters to fully define the function
+       * \param[in] ctx Context (process replica, event, ...) in which the function is evaluated
        * \return Function value at this point \a x
        */
-      inline double F( const std::vector<double>& x, Parameters* ip ) {
-        return function_->f( (double*)&x[0], function_->dim, (void*)ip );
+      inline double F( const std::vector<double>& x, IntegrandContext* ctx ) {
+        return function_->f( (double*)&x[0], function_->dim, (void*)ctx );
       }
       /**
        * Store the event characterized by its _ndim-dimensional point in the phase
@@ -82,8 +195,22 @@ namespace CepGen
        * \brief Prepare the class for events generation
        */
       void setGen();
-      double uniform() const { return gsl_rng_uniform( rng_ ); }
-      //double uniform() const { return rand()/RAND_MAX; }
+      double uniform() { return rng_.uniform(); }
+      /// Draw a point uniformly distributed in a Vegas bin
+      /// \param[out] x Point drawn
+      /// \param[in] n Coordinates of the bin in the generation grid
+      void shootInBin( std::vector<double>& x, const std::vector<int>& n );
+      /// Coordinates of a bin in the generation grid
+      void binCoordinates( int bin, std::vector<int>& n ) const;
+      /**
+       * Shoot a few more points in the cell whose maximum was most often exceeded, and
+       * raise its maximum (with the corresponding correction cycle) once enough points
+       * were probed. The cost of a better estimate of the maxima is thus spread over
+       * the generation of the events, without a complete new pass on the grid.
+       */
+      void refineCells();
+      /// Unweighting procedure, as performed by sample
+      bool samplePoint( std::vector<double>& x );
 
       /// Maximal number of dimensions handled by this Vegas instance
       static constexpr unsigned short max_dimensions_ = 15;
@@ -94,12 +221,22 @@ namespace CepGen
 
       /// Selected bin at which the function will be evaluated
       int vegas_bin_;
+      /// Is a correction cycle running in the selected bin?
+      bool correcting_;
       double correc_;
       double correc2_;
       /// List of parameters to specify the integration range and the physics determining the phase space
       Parameters* input_params_;
-      /// Has the grid been prepared for integration?
-      bool grid_prepared_;
+      /// Default context in which the function is evaluated
+      IntegrandContext* context_;
+      /// Start the next integration from the grid given through setGrid, rather than from a fresh one?
+      bool warm_start_;
+      /// Grid adapted at the last integration (or given as a starting point)
+      Grid grid_;
+      /// Differential cross sections filled during the last integration
+      std::vector<Histogram> histograms_;
+      /// Counters and timings of all steps performed
+      Statistics stats_;
       /// Has the generation been prepared using @a SetGen call? (very time-consuming operation, thus needs to be called once)
       bool gen_prepared_;
       /// Maximal value of the function at one given point
@@ -111,9 +248,22 @@ namespace CepGen
       double f_max_global_;
       std::vector<int> n_;
       std::vector<int> nm_;
+      /// Number of times the maximum of each cell was exceeded during the generation
+      std::vector<unsigned int> overshoots_;
+      /// Cell being refined (-1 if none)
+      int refined_bin_;
+      /// Number of points left to shoot in the cell being refined
+      unsigned int refine_left_;
+      /// Maximal function value found so far in the cell being refined
+      double refine_max_;
+      /// Number of points shot in the cell being refined at each event generation
+      static constexpr unsigned short refine_points_per_event_ = 10;
       /// GSL structure storing the function to be integrated by this Vegas instance (along with its parameters)
       std::unique_ptr<gsl_monte_function> function_;
-      gsl_rng* rng_;
+      /// Random numbers generator for this instance
+      RandomGenerator rng_;
+      /// Interface of @a rng_ to the GSL integration algorithm
+      gsl_rng* gsl_engine_;
       /// Number of function calls to be computed for each point
       int num_converg_;
       /// Number of iterations for the integration
@@ -1,5 +1,10 @@
 #include "utils.h"
 
+#include <fstream>
+#include <thread>
+#include <cstdio>
+#include <unistd.h>
+
 void Map( double expo, double xmin, double xmax, double& out, double& dout, const std::string& var_name_ )
 {
   const double y = xmax/xmin;
@@ -12,7 +17,7 @@ void Map( double expo, double xmin, double xmax, double& out, double& dout, cons
                              var_name_.c_str(), xmin, xmax, y, expo, out, dout ) );
 }
 
-void Mapla( double y, double z, int u, double xm, double xp, double& x, double& d )
+void Mapla( double y, double z, double u, double xm, double xp, double& x, double& d )
 {
   double xmb, xpb, c, yy, zz, alp, alm, am, ap, ax;
 
@@ -33,7 +38,6 @@ void Mapla( double y, double z, int u, double xm, double xp, double& x, double&
 
 double BreitWigner( double er, double gamma, double emin, double emax, double x )
 {
-  if ( x==-1. ) x = drand();
   if ( gamma<1.e-3*er ) { return er; }
 
   const double a = atan( 2.*( emax-er ) / gamma ),
@@ -72,3 +76,21 @@ Form( const std::string fmt, ... )
   return str;
 }
 
+
+bool writeAtomically( const std::string& file, const std::function<void( std::ostream& )>& fill )
+{
+  const std::string tmp_file = Form( "%s.%d.%zx.tmp", file.c_str(), getpid(), std::hash<std::thread::id>()( std::this_thread::get_id() ) );
+  std::ofstream out( tmp_file, std::fstream::out | std::fstream::trunc );
+  if ( !out.is_open() ) return false;
+  try { fill( out ); } catch ( ... ) {
+    out.close();
+    std::remove( tmp_file.c_str() );
+    throw;
+  }
+  out.close();
+  if ( out.fail() || std::rename( tmp_file.c_str(), file.c_str() ) != 0 ) {
+    std::remove( tmp_file.c_str() );
+    return false;
+  }
+  return true;
+}
@@ -6,15 +6,12 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <functional>
+#include <ostream>
+
 #include "CepGen/Core/Exception.h"
 #include "CepGen/Physics/Constants.h"
 
-static std::stringstream error;
-
-/// Provide a random number generated along a uniform distribution between 0 and 1
-//inline double drand() { srand (time(nullptr)); return static_cast<double>(rand())/RAND_MAX; }
-#define drand() static_cast<double>( rand()/RAND_MAX )
-
 /// Format a string using a printf style format descriptor.
 std::string Form(const std::string fmt, ...);
 
@@ -50,7 +47,42 @@ inline std::string colourise( const std::string& str, const Colour::TextColour&
  * > `mapt1`, `mapt2`
  */
 void Map( double expo, double xmin, double xmax, double& out, double& dout, const std::string& var_name="" );
-void Mapla( double y, double z, int u, double xm, double xp, double& x, double& d );
+/**
+ * Same mapping as Map, for a variable whose range is fixed for the whole run
+ * @param[in] expo Exponant
+ * @param[in] xmin Minimal value of the variable
+ * @param[in] ratio Ratio \f$x_{max}/x_{min}\f$ of the range
+ * @param[in] log_ratio Logarithm of the range ratio
+ * @param[out] out The new variable definition
+ * @param[out] dout The differential variant of the new variable definition
+ */
+inline void Map( double expo, double xmin, double ratio, double log_ratio, double& out, double& dout ) {
+  out = xmin*pow( ratio, expo );
+  dout = out*log_ratio;
+}
+/**
+ * Map a variable \f$x\in[x_{min},x_{max}]\f$ such that \f$x-y-z+\sqrt{\lambda(x,y,z)}\f$ is distributed logarithmically,
+ * hence flattening the \f$1/\sqrt{\lambda(x,y,z)}\f$ peaks of the integrand (`mapla` subroutine in ILPAIR)
+ * @param[in] y First argument of the K\"all\'en function \f$\lambda\f$
+ * @param[in] z Second argument of the K\"all\'en function \f$\lambda\f$
+ * @param[in] u Random number, between 0 and 1
+ * @param[in] xm Minimal value of the variable
+ * @param[in] xp Maximal value of the variable
+ * @param[out] x The new variable definition
+ * @param[out] d The differential variant of the new variable definition
+ */
+void Mapla( double y, double z, double u, double xm, double xp, double& x, double& d );
+
+/**
+ * Write a file without ever exposing a partially written version of it: the content is written
+ * under a temporary name unique to the calling process and thread, then renamed. Concurrent writers
+ * thus never share a temporary file (the last renaming wins), and a failed writing leaves no
+ * temporary file behind.
+ * @param[in] file Path to the file to write
+ * @param[in] fill Function writing the content into the temporary file's stream
+ * @return A boolean stating whether the file was written
+ */
+bool writeAtomically( const std::string& file, const std::function<void( std::ostream& )>& fill );
 
 /// Convert a polar angle to a pseudo-rapidity
 inline double thetaToEta( double theta_ ) { return -log( tan( theta_/180.*M_PI/2. ) ); }
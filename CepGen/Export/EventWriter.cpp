@@ -1,4 +1,5 @@
 #include "EventWriter.h"
+#include "CepGen/Core/Tracer.h"
 
 using namespace CepGen::OutputHandler;
 
@@ -25,6 +26,7 @@ EventWriter::~EventWriter()
 void
 EventWriter::operator<<( const Event* evt )
 {
+  TraceRegion( "export write" );
   switch ( type_ ) {
 #ifdef HEPMC_LINKED
     case OutputHandler::ExportHandler::HepMC:
@@ -8,9 +8,10 @@ namespace CepGen
 {
   namespace OutputHandler
   {
-    LHEFHandler::LHEFHandler( const char* filename ) :
+    LHEFHandler::LHEFHandler( const char* filename, bool append ) :
       ExportHandler( ExportHandler::LHE ),
-      lhe_output_( new LHEF::Writer( filename ) )
+      file_( filename, append ? std::fstream::app : std::fstream::trunc ), append_( append ),
+      lhe_output_( new LHEF::Writer( file_ ) )
     {}
 
     void
@@ -41,7 +42,7 @@ namespace CepGen
       run.XMAXUP[0] = 1.;
       run.LPRUP[0] = 1;
       lhe_output_->heprup = run;
-      lhe_output_->init();
+      if ( !append_ ) lhe_output_->init();
     }
 
     void
@@ -69,6 +70,13 @@ namespace CepGen
       lhe_output_->hepeup = out;
       lhe_output_->writeEvent();
     }
+
+    long long
+    LHEFHandler::flush()
+    {
+      file_.flush();
+      return file_.tellp();
+    }
   }
 }
 
@@ -9,6 +9,8 @@
 #include "HepMC/LHEF.h"
 #include "CepGen/Physics/Event.h"
 
+#include <fstream>
+
 namespace CepGen
 {
   namespace OutputHandler
@@ -23,12 +25,20 @@ namespace CepGen
      public:
       /// Class constructor
       /// \param[in] filename Output file path
-      LHEFHandler( const char* filename );
+      /// \param[in] append Append the events to an existing file (e.g. when resuming a run), without writing a new header
+      LHEFHandler( const char* filename, bool append=false );
       void initialise( const Parameters& params );
       /// Writer operator
       void operator<<( const Event* );
+      /// Flush all events written so far into the file
+      /// \return Current size of the output file (in bytes)
+      long long flush();
 
      private:
+      /// Output file stream
+      std::ofstream file_;
+      /// Are we appending events to an existing file?
+      bool append_;
       /// Writer object (from HepMC)
       std::unique_ptr<LHEF::Writer> lhe_output_;
       LHEF::HEPRUP run_;
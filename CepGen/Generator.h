@@ -9,6 +9,13 @@
 
 #include "CepGen/Core/Vegas.h"
 #include "CepGen/Core/Timer.h"
+#include "CepGen/Core/Profiler.h"
+#include "CepGen/Core/Tracer.h"
+#include "CepGen/Core/EventStream.h"
+#include "CepGen/Core/Checkpoint.h"
+#include "CepGen/Core/IntegrationCache.h"
+#include "CepGen/Core/Gridpack.h"
+#include "CepGen/Core/RunReport.h"
 
 #include "CepGen/Physics/Physics.h"
 
@@ -42,8 +49,19 @@ namespace CepGen
    * restrictions imposed on this phase space. \f$x\f$ is therefore an array of random
    * numbers defined inside its boundaries (as normalised so that \f$\forall i<\mathrm{ndim}\f$,
    * \f$0<x_i<1\f$.
+   * The last argument is the IntegrandContext in which the function is evaluated: the
+   * run parameters are only read, hence several contexts can be evaluated concurrently.
    */
   double f( double*, size_t, void* );
+  /**
+   * Function to be integrated, for a batch of points given in the structure-of-arrays
+   * form (the \f$i\f$-th coordinate of the \f$j\f$-th point being x[i*num_points+j]).
+   * The weights are the ones of successive calls to the single-point function, up to
+   * the floating point rounding; the process' event is left undefined.
+   * The arguments are the coordinates, the number of points, the number of dimensions,
+   * the IntegrandContext, and the output weights.
+   */
+  void f( const double*, size_t, size_t, void*, double* );
 
   ////////////////////////////////////////////////////////////////////////////////
 
@@ -90,29 +108,108 @@ namespace CepGen
        * \param[out] err The absolute integration error on the computed cross-section, in pb
        */
       void computeXsection( double& xsec, double& err );
+      /// Integration grid adapted at the last cross section computation
+      const Vegas::Grid& integrationGrid() const;
+      /**
+       * Start the next cross section computation from a grid adapted for a close phase space (e.g. a
+       * neighbouring point of a scan), with a short re-adaptation rather than a full warm-up. Without it,
+       * each computation starts from a fresh grid. A result obtained from a given grid is not stored in
+       * the integration cache.
+       * \param[in] grid Grid obtained from integrationGrid() on the other Generator object
+       */
+      void setIntegrationGrid( const Vegas::Grid& grid ) { start_grid_ = grid; }
+      /// Differential cross sections filled during the last cross section computation (see Parameters::histograms)
+      const std::vector<Histogram>& histograms() const;
       double crossSection() const { return cross_section_; }
       double crossSectionError() const { return cross_section_error_; }
+      /// Number of evaluations of the function in the default context (integration and events generation)
+      unsigned long long numFunctionCalls() const { return ( context_ ) ? context_->num_calls : 0; }
       /**
        * Generate one single event given the phase space computed by Vegas in the integration step
        * \return A pointer to the Event object generated in this run
        */
       Event* generateOneEvent();
+      /**
+       * Book a range of unweighted events, produced in a background thread ahead of their
+       * consumption, e.g. `for ( const Event& ev : gen.events( 1000 ) ) { ... }`.
+       * \note The generator is not to be used by the caller while the stream is iterated
+       * \param[in] num_events Number of events to produce
+       * \param[in] batch_size Number of events produced and handed over to the caller in one go
+       * \return A single-pass range of events (see EventStream for the lifetime rules)
+       */
+      EventStream events( unsigned long num_events, unsigned int batch_size=100 );
+      /// Pick the next unweighted phase space point, without computing the event kinematics (the cross section is computed if needed)
+      /// \param[out] x The point selected
+      void samplePoint( std::vector<double>& x );
+      /// Evaluation context with an independent replica of the process, to compute events concurrently to the sampling
+      std::unique_ptr<IntegrandContext> replicaContext() const;
+      /// Compute the full event kinematics for a phase space point picked by samplePoint
+      /// \param[in] x The point to materialise
+      /// \param[inout] ctx Evaluation context (as obtained from replicaContext) in which the event is computed
+      /// \return The event computed, owned by the process of @a ctx
+      const Event& materialise( const std::vector<double>& x, IntegrandContext& ctx );
+      /// Snapshot of the current events generation state (the cross section is computed if needed)
+      Checkpoint checkpoint();
+      /**
+       * Restore the events generation state from a checkpoint file, bypassing the
+       * integration and the generation grid preparation. The following events
+       * are the ones which would have been generated by the interrupted run.
+       * \param[in] file Path to the checkpoint file
+       * \return The checkpoint restored (number of events generated, output size, ...)
+       */
+      Checkpoint resume( const std::string& file );
+      /// Restore the events generation state from a checkpoint already loaded (see resume( const std::string& ))
+      void resume( const Checkpoint& ckpt );
+      /// Snapshot of the run parameters, integration results and generation grid, to be
+      /// shared by several generation jobs (the cross section and grid are computed if needed)
+      Gridpack gridpack();
+      /**
+       * Prepare the events generation from a gridpack, bypassing the integration and the
+       * generation grid preparation. The run parameters are taken from the gridpack if it
+       * holds them, otherwise the current ones have to match the prepared run.
+       * \param[in] gp Gridpack, as obtained from gridpack() on the preparation run
+       * \param[in] seed Seed of the random sequences for this job (the preparation run
+       *  sequences are continued if the seed is the one of the preparation run)
+       */
+      void loadGridpack( const Gridpack& gp, unsigned long long seed );
+      /// Summary of the run so far (also written at the end of the run if a report file is set in the parameters,
+      /// and the integrand was prepared)
+      RunReport report();
       /// Number of dimensions on which the integration is performed
       inline size_t numDimensions() const {
         if ( !parameters->process() ) return 0;
         return parameters->process()->numDimensions( parameters->kinematics.mode );
       }
       /// Compute one single point from the total phase space
+      /// \note The function is only prepared at the first call (or after a clearRun call)
       /// \param[in] x_ the n-dimensional point to compute
       /// \return the function value for the given point
       inline double computePoint( double* x_ ) {
-        prepareFunction();
-        double res = f( x_, numDimensions(), (void*)parameters.get() );
-        std::ostringstream os;
-        for ( unsigned int i=0; i<numDimensions(); i++ ) { os << x_[i] << " "; }
-        Debugging( Form( "Result for x[%zu] = ( %s):\n\t%10.6f", numDimensions(), os.str().c_str(), res ) );
+        if ( !context_ || !context_->prepared ) prepareFunction();
+        double res = f( x_, numDimensions(), (void*)context_.get() );
+        if ( Logger::get().level >= Logger::Debug ) {
+          std::ostringstream os;
+          for ( unsigned int i=0; i<numDimensions(); i++ ) { os << x_[i] << " "; }
+          Debugging( Form( "Result for x[%zu] = ( %s):\n\t%10.6f", numDimensions(), os.str().c_str(), res ) );
+        }
         return res;
       }
+      /**
+       * Compute a large collection of points from the total phase space, shared
+       * between several threads (each with its own replica of the process)
+       * \param[in] x Coordinates of all points, one after the other (numDimensions() values per point)
+       * \param[in] num_points Number of points to compute
+       * \param[in] num_threads Number of threads to use (0 for the number of cores available)
+       * \return The function value for each point
+       */
+      std::vector<double> computePoints( const double* x, size_t num_points, unsigned short num_threads=0 );
+      /**
+       * Compute all points stored in a binary file (mapped in memory rather than read)
+       * \param[in] file Path to a file of native doubles, numDimensions() values per point
+       * \param[in] num_threads Number of threads to use (0 for the number of cores available)
+       * \return The function value for each point
+       */
+      std::vector<double> computePoints( const std::string& file, unsigned short num_threads=0 );
       /// Physical Parameters used in the events generation and cross-section computation
       std::unique_ptr<Parameters> parameters;
       /// Last event generated in this run
@@ -121,14 +218,35 @@ namespace CepGen
    private:
       /// Prepare the function before its integration (add particles/compute kinematics/...)
       void prepareFunction();
+      /// Retrieve the integration results from a cache rather than integrating
+      /// \return A boolean stating whether the results were found
+      bool retrieveIntegration( const IntegrationCache& cache );
+      /// Store the integration results (and the generation grid if events are to be generated) in a cache
+      void storeIntegration( const IntegrationCache& cache );
+      /// Snapshot of the integration results, and of the generation grid if requested (prepared if needed)
+      IntegrationCache::Entry integrationEntry( bool with_generation_state );
+      /// Restore the integration results (and the generation grid if any)
+      void restoreIntegration( const IntegrationCache::Entry& entry );
+      /// Default context in which the function is evaluated
+      std::unique_ptr<IntegrandContext> context_;
+      /// Number of points handed over to a thread in one go by computePoints
+      static constexpr size_t block_size_ = 1024;
       /// Vegas instance which will integrate the function
       std::unique_ptr<Vegas> vegas_;
+      /// Grid to start the next integration from
+      Vegas::Grid start_grid_;
       /// Cross section value computed at the last integration
       double cross_section_;
       /// Error on the cross section as computed in the last integration
       double cross_section_error_;
       /// Has a first integration beed already performed?
       bool has_cross_section_;
+      /// Were the integration results restored rather than computed?
+      bool integration_restored_;
+      /// Time since the construction of this object
+      Timer run_timer_;
+      /// Recording of the timeline of the run (if requested)
+      std::unique_ptr<Tracer::Session> trace_session_;
   };
 }
 
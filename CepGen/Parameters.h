@@ -4,8 +4,10 @@
 #include "CepGen/Processes/GenericProcess.h"
 #include "CepGen/Physics/Kinematics.h"
 #include "CepGen/Core/TamingFunction.h"
+#include "CepGen/Core/Histogram.h"
 
 #include <memory>
+#include <vector>
 
 namespace CepGen
 {
@@ -30,6 +32,8 @@ namespace CepGen
 
       /// Process for which the cross-section will be computed and the events will be generated
       Process::GenericProcess* process() { return process_.get(); }
+      /// Process for which the cross-section will be computed and the events will be generated
+      const Process::GenericProcess* process() const { return process_.get(); }
       std::string processName() const { return process_->name(); }
       /// Set the process to study
       void setProcess( Process::GenericProcess* proc ) { process_.reset( proc ); }
@@ -47,14 +51,24 @@ namespace CepGen
       /// Collection of Vegas integrator parameters
       struct Vegas
       {
-        Vegas() : ncvg( 100000 ), itvg( 10 ), npoints( 100 ), first_run( true ) {}
+        Vegas() : ncvg( 100000 ), itvg( 10 ), npoints( 100 ), seed( 0 ), stream( 0 ), refine_npoints( 0 ), precision( 0. ) {}
         unsigned int ncvg; // ??
         /// Maximal number of iterations to perform by VEGAS
         unsigned int itvg;
         /// Number of points to "shoot" in each integration bin by the algorithm
         unsigned int npoints;
-        /// Is it the first time the integrator is run?
-        bool first_run;
+        /// Seed of the random numbers sequences used for the integration and the events generation
+        unsigned long long seed;
+        /// Index of the first random numbers stream drawn by the run (see RandomGenerator): the integrator uses this
+        /// stream, the process the next one. Runs sharing a seed (channels of a cocktail, farm workers) are given
+        /// distinct streams rather than shifted seeds, to keep them independent from any other run
+        unsigned long long stream;
+        /// Number of points to "shoot" in a bin whose maximum was exceeded during the events generation (0, the default, to disable the refinement)
+        unsigned int refine_npoints;
+        /// Relative precision at which the integration iterations are stopped (0 to perform all of them)
+        double precision;
+        /// Directory where the integration results are cached, to be reused by an identical run (empty to disable)
+        std::string cache_directory;
       };
       Vegas vegas;
 
@@ -62,7 +76,8 @@ namespace CepGen
 
       struct Generation
       {
-        Generation() : enabled( false ), maxgen( 0 ), symmetrise( false ), ngen( 0 ), gen_print_every( 1 ) {}
+        Generation() : enabled( false ), maxgen( 0 ), symmetrise( false ), ngen( 0 ), gen_print_every( 1 ),
+                       checkpoint_every( 0 ), checkpoint_file( "cepgen.checkpoint" ), metrics_period( 10. ) {}
         /// Are we generating events ? (true) or are we only computing the cross-section ? (false)
         bool enabled;
         /// Maximal number of events to generate in this run
@@ -75,21 +90,80 @@ namespace CepGen
         unsigned int ngen;
         /// Frequency at which the events are displayed to the end-user
         unsigned int gen_print_every;
+        /// Number of events between two checkpoints of the generation state (0 to disable)
+        unsigned int checkpoint_every;
+        /// Path to the file holding the last checkpoint of the generation state
+        std::string checkpoint_file;
+        /// Path to the file where the generation metrics are periodically exported (empty to disable)
+        std::string metrics_file;
+        /// Time between two exports of the generation metrics, in seconds
+        double metrics_period;
       };
       Generation generation;
 
-      void setStorage( bool store ) { store_ = store; }
-      /// Are the events generated in this run to be stored in the output file ?
-      bool storage() const { return store_; }
+      //----- cocktail of processes modes
+
+      /// Sub-configuration of the process, generated along with the others in a cocktail run
+      struct CocktailChannel
+      {
+        CocktailChannel( Kinematics::ProcessMode mode_=Kinematics::ElasticElastic, StructureFunctions sf=SuriYennie, Particle::ParticleCode pair_=Particle::Muon ) :
+          mode( mode_ ), remnant_mode( sf ), pair( pair_ ) {}
+        /// Type of kinematics (elastic, single- or double-dissociative)
+        Kinematics::ProcessMode mode;
+        /// Structure functions used for the dissociated protons
+        StructureFunctions remnant_mode;
+        /// Type of particles produced in the central system
+        Particle::ParticleCode pair;
+      };
+      /// Channels integrated separately, then generated together (empty for a single channel run)
+      std::vector<CocktailChannel> cocktail;
+
+      //----- cross section scans
+
+      /// Collection of parameters for a scan of the cross section
+      struct Scan
+      {
+        Scan() : num_threads( 0 ), warm_start( true ) {}
+        /// Fill the list of values with @a num_points points regularly spaced in [@a min, @a max]
+        void setRange( double min, double max, unsigned int num_points ) {
+          values.clear();
+          for ( unsigned int i=0; i<num_points; i++ ) values.emplace_back( ( num_points > 1 ) ? min+( max-min )*i/( num_points-1 ) : min );
+        }
+        /// Name of the parameter scanned (pt_min, eta_max, mx_max, sqrt_s, ...)
+        std::string parameter;
+        /// Values of the parameter at which the cross section is computed
+        std::vector<double> values;
+        /// Number of points computed concurrently (0 for the number of cores available)
+        unsigned short num_threads;
+        /// Start the integration of each point from the grid adapted for the previous one (instead of a flat grid with a full warm-up)
+        bool warm_start;
+      };
+      Scan scan;
 
       //----- taming functions
 
       /// Functionals to be used to account for rescattering corrections (implemented within the process)
       TamingFunctionsCollection taming_functions;
 
+      //----- differential cross sections
+
+      /// Distributions filled with the integrand weights during the integration (see Histogram)
+      std::vector<Histogram> histograms;
+
+      //----- run report
+
+      /// Path to the file where the run summary is written at the end of the run (empty to disable)
+      std::string report_file;
+
+      //----- timeline trace
+
+      /// Path to the file where the timeline of the run is written in the Chrome trace-event format (empty to disable)
+      std::string trace_file;
+      /// Maximal number of regions kept in the timeline of each thread (the oldest ones are dropped)
+      unsigned int trace_capacity;
+
     private:
       std::unique_ptr<Process::GenericProcess> process_;
-      bool store_;
   };
 }
 
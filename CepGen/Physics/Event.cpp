@@ -7,6 +7,12 @@ namespace CepGen
     time_generation( -1. ), time_total( -1. )
   {}
 
+  Event::Event( const Event& ev ) :
+    num_hadronisation_trials( ev.num_hadronisation_trials ),
+    time_generation( ev.time_generation ), time_total( ev.time_total ),
+    particles_( ev.particles_ ), last_particle_( particles_.end() )
+  {}
+
   Event::~Event()
   {}
 
@@ -15,6 +15,8 @@ namespace CepGen
   class Event {
     public:
       Event();
+      /// Copy the full particles content and timing information of another event
+      Event( const Event& );
       ~Event();
       /**
        * \brief Copies all the relevant quantities from one Event object to another
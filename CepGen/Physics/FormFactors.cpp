@@ -1,4 +1,5 @@
 #include "FormFactors.h"
+#include "CepGen/Core/Profiler.h"
 
 namespace CepGen
 {
@@ -134,7 +135,7 @@ namespace CepGen
           amu2 = q2+q2_0; // shift the overall scale
     float xuv, xdv, xus, xds, xss, xg;
 
-    grv95lo_( x, amu2, xuv, xdv, xus, xds, xss, xg );
+    { ProfileRegion( "GRV" ); grv95lo_( x, amu2, xuv, xdv, xus, xds, xss, xg ); }
 
     DebuggingInsideLoop( Form( "Form factor content at xB = %e (scale = %f GeV^2):\n\t"
                                "  valence quarks: u / d     = %e / %e\n\t"
@@ -6,6 +6,7 @@
 #include "CepGen/Core/utils.h"
 #include "Constants.h"
 #include "Particle.h"
+#include "StructureFunctions.h"
 
 extern "C"
 {
@@ -49,6 +50,12 @@ namespace CepGen
   FormFactors FioreBrasseFormFactors( double q2, double mi2, double mf2 );
   /// Szczurek-Uleschenko inelastic form factors
   FormFactors SzczurekUleshchenkoFormFactors( double q2, double mi2, double mf2 );
+  /// Inelastic form factors for a structure functions modelling known at compile time (Suri-Yennie by default)
+  template<StructureFunctions sf> inline FormFactors InelasticFormFactors( double q2, double mi2, double mf2 ) { return SuriYennieFormFactors( q2, mi2, mf2 ); }
+  /// Brasse et al. inelastic form factors (also used for the Fiore valence/sea modellings)
+  template<> inline FormFactors InelasticFormFactors<Fiore>( double q2, double mi2, double mf2 ) { return FioreBrasseFormFactors( q2, mi2, mf2 ); }
+  /// Szczurek-Uleschenko inelastic form factors
+  template<> inline FormFactors InelasticFormFactors<SzczurekUleshchenko>( double q2, double mi2, double mf2 ) { return SzczurekUleshchenkoFormFactors( q2, mi2, mf2 ); }
 }
 
 #endif
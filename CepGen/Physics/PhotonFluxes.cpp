@@ -1,4 +1,5 @@
 #include "PhotonFluxes.h"
+#include "CepGen/Core/Profiler.h"
 
 namespace CepGen
 {
@@ -47,7 +48,7 @@ namespace CepGen
         float mu2 = Q2+Q02; // scale is shifted
 
         float xuv, xdv, xus, xds, xss, xg;
-        grv95lo_( x_Bjorken, mu2, xuv, xdv, xus, xds, xss, xg );
+        { ProfileRegion( "GRV" ); grv95lo_( x_Bjorken, mu2, xuv, xdv, xus, xds, xss, xg ); }
 
         const double F2_aux = 4./9.*( xuv + 2.*xus )
                             + 1./9.*( xdv + 2.*xds )
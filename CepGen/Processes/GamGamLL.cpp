@@ -1,30 +1,42 @@
 #include "GamGamLL.h"
+#include "CepGen/Core/Profiler.h"
 
 using namespace CepGen::Process;
 
+namespace
+{
+  /// Lane-wise Map (logarithmic mapping of a variable between xmin and xmax)
+  template<typename V> inline void
+  mapLanes( const V& expo, const V& xmin, const V& xmax, V& out, V& dout )
+  {
+    const V ratio = xmax/xmin;
+    out = xmin*CepGen::Simd::pow( ratio, expo );
+    dout = out*CepGen::Simd::log( ratio );
+  }
+  /// Lane-wise Mapla (mapping flattening the Kallen function peaks of a variable between xm and xp)
+  template<typename V> inline void
+  maplaLanes( const V& y, double z, const V& u, const V& xm, const V& xp, V& x, V& d )
+  {
+    const V xmb = xm-y-z, xpb = xp-y-z, c = -4.*y*z;
+    const V am = xmb+CepGen::Simd::sqrt( xmb*xmb+c ), ap = xpb+CepGen::Simd::sqrt( xpb*xpb+c );
+    const V yy = ap/am, zz = am*CepGen::Simd::pow( yy, u );
+    x = y+z+( zz-c/zz )*0.5;
+    d = CepGen::Simd::sqrt( ( x-y-z )*( x-y-z )+c )*CepGen::Simd::log( yy );
+  }
+}
+
 GamGamLL::GamGamLL( int nopt ) : GenericProcess( "lpair", "pp -> p(*) (gamma gamma -> l+ l-) p(*)" ),
-  n_opt_( nopt ),
-  MX2_( 0. ), MY2_( 0. ), Ml12_( 0. ), Ml22_( 0. ),
+  compute_weight_( nullptr ), compute_weights_( nullptr ), n_opt_( nopt ),
+  Ml12_( 0. ), Ml22_( 0. ),
   ep1_( 0. ), ep2_( 0. ), p_cm_( 0. ),
-  w12_( 0. ), w31_( 0. ), dw31_( 0. ), w52_( 0. ), dw52_( 0. ),
-  ec4_( 0. ), pc4_( 0. ), mc4_( 0. ), w4_( 0. ),
-  p12_( 0. ), p1k2_( 0. ), p2k1_( 0. ),
-  p13_( 0. ), p14_( 0. ), p25_( 0. ),
-  q1dq_( 0. ), q1dq2_( 0. ),
-  s1_( 0. ), s2_( 0. ),
-  epsi_( 0. ),
-  g5_( 0. ), g6_( 0. ), a5_( 0. ), a6_( 0. ), bb_( 0. ),
-  gram_( 0. ),
-  dd1_( 0. ), dd2_( 0. ), dd3_( 0. ), dd4_( 0. ), dd5_( 0. ),
-  delta_( 0. ),
-  g4_( 0. ), sa1_( 0. ), sa2_( 0. ),
-  sl1_( 0. ),
-  cos_theta4_( 0. ), sin_theta4_( 0. ),
-  al4_( 0. ), be4_( 0. ), de3_( 0. ), de5_( 0. ),
-  pt4_( 0. ),
-  jacobian_( 0. ),
-  cot_theta1_( -99999. ), cot_theta2_( 99999. )
-{}
+  w12_( 0. ), dw31_( 0. ), dw52_( 0. ),
+  p12_( 0. ), sl1_( 0. ), ss_( 0. ),
+  cot_theta1_( -99999. ), cot_theta2_( 99999. ),
+  w4_min_( 0. ), w4_range_( 0. ), log_w4_range_( 0. )
+{
+  settings(); // reject the unimplemented mapping optimisations before any run
+  selectWeightComputation();
+}
 
 void
 GamGamLL::addEventContent()
@@ -55,387 +67,47 @@ GamGamLL::numDimensions( const Kinematics::ProcessMode& process_mode ) const
   }
 }
 
-bool
-GamGamLL::pickin()
-{
-  DebuggingInsideLoop( Form( "Optimised mode? %i", n_opt_ ) );
-
-  jacobian_ = 0.;
 
-  w4_ = mc4_*mc4_;
-
-  // sig1 = sigma and sig2 = sigma' in [1]
-  const double sig = mc4_+MY_;
-  double sig1 = sig*sig,
-         sig2 = sig1;
-
-  DebuggingInsideLoop( Form( "mc4 = %f\n\t"
-                             "sig1 = %f\n\t"
-                             "sig2 = %f", mc4_, sig1, sig2 ) );
-
-  // Mass difference between the first outgoing particle and the first incoming
-  // particle
-  w31_ = MX2_-w1_;
-  // Mass difference between the second outgoing particle and the second
-  // incoming particle
-  w52_ = MY2_-w2_;
-  // Mass difference between the two incoming particles
-  w12_ = w1_-w2_;
-  // Mass difference between the central two-photons system and the second
-  // outgoing particle
-  const double d6 = w4_-MY2_;
-
-  DebuggingInsideLoop( Form( "w1 = %f\n\t"
-                             "w2 = %f\n\t"
-                             "w3 = %f\n\t"
-                             "w4 = %f\n\t"
-                             "w5 = %f",
-                             w1_, w2_, MX2_, w4_, MY2_ ) );
-
-  DebuggingInsideLoop( Form( "w31 = %f\n\tw52 = %f\n\tw12 = %f", w31_, w52_, w12_ ) );
-
-  const double ss = s_+w12_;
-
-  const double rl1 = std::pow(ss, 2)-4.*w1_*s_; // lambda(s, m1**2, m2**2)
-  if ( rl1 <= 0. ) { InWarning( Form( "rl1 = %f <= 0", rl1 ) ); return false; }
-  sl1_ = sqrt( rl1 );
-
-  s2_ = 0.;
-  double ds2 = 0.;
-  if ( n_opt_ == 0 ) {
-    const double smax = s_+MX2_-2.*MX_*sqs_;
-    Map( x(2), sig1, smax, s2_, ds2, "s2" );
-    sig1 = s2_; //FIXME!!!!!!!!!!!!!!!!!!!!
-  }
-
-  DebuggingInsideLoop( Form( "s2 = %f", s2_ ) );
-
-  //std::cout << "s=" << _s << ", w3=" << MX2_ << ", sig1=" << sig1 << std::endl;
-  const double sp = s_+MX2_-sig1,
-               d3 = sig1-w2_;
+template<typename V> CepGen::Simd::Mask<V>
+GamGamLL::t1Range( const V& sig1, const V& mx2, V& t1_min, V& t1_max ) const
+{
+  const V sp = s_+mx2-sig1,
+          d3 = sig1-w2_,
+          w31 = mx2-w1_;
 
-  const double rl2 = sp*sp-4.*s_*MX2_; // lambda(s, m3**2, sigma)
-  if ( rl2 <= 0. ) { InWarning( Form( "rl2 = %f <= 0", rl2 ) ); return false; }
-  const double sl2 = sqrt( rl2 );
+  const V rl2 = sp*sp-4.*s_*mx2; // lambda(s, m3**2, sigma)
+  const V sl2 = Simd::sqrt( rl2 );
 
-  //std::cout << "ss=" << ss << ", sp=" << sp << ", sl1=" << sl1_ << ", sl2=" << sl2 << std::endl;
-  double t1_max = w1_+MX2_-( ss*sp+sl1_*sl2 )/( 2.*s_ ), // definition from eq. (A.4) in [1]
-         t1_min = ( w31_*d3+( d3-w31_ )*( d3*w1_-w31_*w2_ )/s_ )/t1_max; // definition from eq. (A.5) in [1]
+  t1_max = w1_+mx2-( ss_*sp+sl1_*sl2 )/( 2.*s_ ); // definition from eq. (A.4) in [1]
+  t1_min = ( w31*d3+( d3-w31 )*( d3*w1_-w31*w2_ )/s_ )/t1_max; // definition from eq. (A.5) in [1]
 
   // FIXME dropped in CDF version
-  if ( t1_max > -cuts_.q2_min ) { InWarning( Form( "t1max = %f > -q2min = %f", t1_max, -cuts_.q2_min ) ); return false; }
-  if ( t1_min < -cuts_.q2_max && cuts_.q2_max>=0. ) { Debugging( Form( "t1min = %f < -q2max = %f", t1_min, -cuts_.q2_max ) ); return false; }
-  if ( t1_max < -cuts_.q2_max && cuts_.q2_max>=0. ) t1_max = -cuts_.q2_max;
-  if ( t1_min > -cuts_.q2_min )                     t1_min = -cuts_.q2_min;
-  /////
-
-  // t1, the first photon propagator, is defined here
-  t1_ = 0.;
-  double dt1 = 0.;
-  Map( x(0), t1_min, t1_max, t1_, dt1, "t1" );
-  // changes wrt mapt1 : dx->-dx
-  dt1 = -dt1;
-
-  DebuggingInsideLoop( Form( "Definition of t1 = %f according to\n\t"
-                             "(t1min, t1max) = (%f, %f)", t1_, t1_min, t1_max ) );
-
-  dd4_ = w4_-t1_;
-
-  const double d8 = t1_-w2_,
-	       t13 = t1_-w1_-MX2_;
-
-  sa1_ = -std::pow( t1_-w31_, 2 )/4.+w1_*t1_;
-  if ( sa1_ >= 0. ) { InWarning( Form( "sa1_ = %f >= 0", sa1_ ) ); return false; }
-
-  const double sl3 = sqrt( -sa1_ );
-
-  // one computes splus and (s2x=s2max)
-  double splus, s2max;
-  if ( w1_ != 0. ) {
-    const double sb =( s_*( t1_-w31_ )+w12_*t13 )/( 2.*w1_ )+MX2_,
-                 sd = sl1_*sl3/w1_,
-                 se =( s_*( t1_*( s_+t13-w2_ )-w2_*w31_ )+MX2_*( w12_*d8+w2_*MX2_ ) )/w1_;
-
-    if ( fabs( ( sb-sd )/sd )>=1. ) { splus = sb-sd; s2max = se/splus; }
-    else                            { s2max = sb+sd; splus = se/s2max; }
-  }
-  else { // 3
-    s2max = ( s_*(t1_*(s_+d8-MX2_)-w2_*MX2_ )+w2_*MX2_*( w2_+MX2_-t1_ ) )/( ss*t13 );
-    splus = sig2;
-  }
-  // 4
-  double s2x = s2max;
-
-  DebuggingInsideLoop( Form( "s2x = s2max = %f", s2x ) );
-
-  if ( n_opt_ < 0 ) { // 5
-    if ( splus > sig2 ) {
-      sig2 = splus;
-      DebuggingInsideLoop( Form( "sig2 truncated to splus = %f", splus ) );
-    }
-    if ( n_opt_ < -1 ) { Map( x(2), sig2, s2max, s2_, ds2, "s2" ); }
-    else               { Mapla( t1_, w2_, x(2), sig2, s2max, s2_, ds2 ); } // n_opt_==-1
-    s2x = s2_;
-  }
-  else if ( n_opt_ == 0 ) { s2x = s2_; } // 6
-
-  DebuggingInsideLoop( Form( "s2x = %f", s2x ) );
-
-  // 7
-  const double r1 = s2x-d8,
-               r2 = s2x-d6;
-
-  const double rl4 = ( r1*r1-4.*w2_*s2x )*( r2*r2-4.*MY2_*s2x );
-  if ( rl4 <= 0. ) {
-    DebuggingInsideLoop( Form( "rl4 = %f <= 0", rl4 ) );
-    return false;
-  }
-  const double sl4 = sqrt( rl4 );
-
-  // t2max, t2min definitions from eq. (A.12) and (A.13) in [1]
-  const double t2_max = w2_+MY2_-( r1*r2+sl4 )/s2x * 0.5,
-               t2_min = ( w52_*dd4_+( dd4_-w52_ )*( dd4_*w2_-w52_*t1_ )/s2x )/t2_max;
-
-  // t2, the second photon propagator, is defined here
-  t2_ = 0.;
-  double dt2 = 0.;
-  Map( x(1), t2_min, t2_max, t2_, dt2, "t2" );
-  // changes wrt mapt2 : dx->-dx
-
-  dt2 = -dt2;
-
-  // \f$\delta_6=m_4^2-m_5^2\f$ as defined in Vermaseren's paper
-  const double tau = t1_-t2_,
-               r3 = dd4_-t2_,
-               r4 = w52_-t2_;
-
-  DebuggingInsideLoop( Form( "r1 = %f\n\tr2 = %f\n\tr3 = %f\n\tr4 = %f", r1, r2, r3, r4 ) );
-
-  const double b = r3*r4-2.*( t1_+w2_ )*t2_,
-               c = t2_*d6*d8+( d6-d8 )*( d6*w2_-d8*MY2_ );
-
-  const double t25 = t2_-w2_-MY2_;
-
-  sa2_ = -r4*r4/4.+w2_*t2_;
-  if ( sa2_ >= 0. ) { InWarning( Form( "sa2_ = %f >= 0", sa2_ ) ); return false; }
-
-  const double sl6 = 2.*sqrt( -sa2_ );
-
-  g4_ = -r3*r3/4.+t1_*t2_;
-  if ( g4_ >= 0. )  { InWarning( Form( "g4_ = %f >= 0", g4_ ) );   return false; }
-
-  const double sl7 = 2.*sqrt( -g4_ ),
-               sl5 = sl6*sl7;
-
-  double s2p, s2min;
-  if ( fabs( ( sl5-b )/sl5 ) >= 1. ) {
-    s2p = ( sl5-b )/t2_ * 0.5;
-    s2min = c/( t2_*s2p );
-  }
-  else { // 8
-    s2min = ( -sl5-b )/t2_ * 0.5;
-    s2p = c/( t2_*s2min );
-  }
-  // 9
-  if ( n_opt_ > 1 )       Map( x( 2 ), s2min, s2max, s2_, ds2, "s2" );
-  else if ( n_opt_ == 1 ) Mapla( t1_, w2_, x( 2 ), s2min, s2max, s2_, ds2 );
-
-  const double ap = -0.25*std::pow( s2_+d8, 2 )+s2_*t1_;
-
-  DebuggingInsideLoop( Form( "s2 = %f, s2max = %f, splus = %f", s2_, s2max, splus ) );
-
-  if ( w1_!=0. ) dd1_ = -0.25 * ( s2_-s2max ) * ( s2_-splus ) * w1_; // 10
-  else           dd1_ =  0.25 * ( s2_-s2max ) * ss * t13;
-  // 11
-  dd2_ = -t2_*( s2_-s2p )*( s2_-s2min ) * 0.25;
-
-  DebuggingInsideLoop( Form( "t2 =%f\n\ts2 =%f\n\ts2p=%f\n\ts2min=%f\n\tdd2=%f", t2_, s2_, s2p, s2min, dd2_ ) );
-
-  const double yy4 = cos( M_PI*x( 3 ) );
-  const double dd = dd1_*dd2_;
-  p12_ = ( s_-w1_-w2_ )*0.5;
-  const double st = s2_-t1_-w2_;
-  const double delb = ( 2.*w2_*r3+r4*st )*( 4.*p12_*t1_-( t1_-w31_ )*st )/( 16.*ap );
-
-  if ( dd <= 0. ) {
-    DebuggingInsideLoop( Form( "dd = %e <= 0\n\tdd1 = %e\tdd2 = %e", dd, dd1_, dd2_ ) );
-    return false;
+  Simd::Mask<V> ok = ( rl2 > 0. ) && !( t1_max > -cuts_.q2_min );
+  if ( cuts_.q2_max >= 0. ) {
+    ok = ok && !( t1_min < -cuts_.q2_max );
+    t1_max = Simd::select( t1_max < -cuts_.q2_max, Simd::broadcast<V>( -cuts_.q2_max ), t1_max );
   }
-
-  delta_ = delb - yy4*st*sqrt( dd )/ ap * 0.5;
-  s1_ = t2_+w1_+( 2.*p12_*r3-4.*delta_ )/st;
-
-  if ( ap >= 0. ) {
-    DebuggingInsideLoop( Form( "ap = %f >= 0", ap ) );
-    return false;
-  }
-
-  jacobian_ = ds2
-            * dt1
-            * dt2
-            * M_PI*M_PI/( 8.*sl1_*sqrt( -ap ) );
-
-  DebuggingInsideLoop( Form( "Jacobian = %e", jacobian_ ) );
-
-  gram_ = ( 1.-yy4*yy4 )*dd/ap;
-
-  p13_ = -t13 * 0.5;
-  p14_ = (tau+s1_-MX2_) * 0.5;
-  p25_ = -t25 * 0.5;
-
-  /*const double //p15 = (s_+t2_-s1_-w2_)/2.,
-               //p23 = (s_+t1_-s2_-w1_)/2.,
-               //p24 = (s2_-tau-MY2_)/2.,
-               //p34 = (s1_-MX2_-w4_)/2.,
-               //p35 = (s_+w4_-s1_-s2_)/2.,
-               //p45 = (s2_-w4_-MY2_)/2.;*/
-
-  p1k2_ = ( s1_-t2_-w1_ ) * 0.5;
-  p2k1_ = st * 0.5;
-
-  double s1p, s1m;
-  if ( w2_ != 0. ) {
-    const double sbb = ( s_*( t2_-w52_ )-w12_*t25 )/w2_ * 0.5 + MY2_,
-                 sdd = sl1_*sl6/w2_ * 0.5,
-                 see = ( s_*( t2_*( s_+t25-w1_ )-w1_*w52_ )+MY2_*( w1_*MY2_-w12_*( t2_-w1_ ) ) )/w2_;
-    if ( sbb/sdd >= 0. ) { s1p = sbb+sdd; s1m = see/s1p; }
-    else                 { s1m = sbb-sdd; s1p = see/s1m; } // 12
-    dd3_ = -w2_*( s1p-s1_ )*( s1m-s1_ ) * 0.25; // 13
-  }
-  else { // 14
-    s1p = ( s_*( t2_*( s_-MY2_+t2_-w1_ )-w1_*MY2_ )+w1_*MY2_*( w1_+MY2_-t2_ ) )/( t25*( s_-w12_ ) );
-    dd3_ = -t25*( s_-w12_ )*( s1p-s1_ ) * 0.25;
-  }
-  // 15
-  //const double acc3 = (s1p-s1_)/(s1p+s1_);
-
-  const double ssb = t2_+w1_-r3*( w31_-t1_ )/t1_ * 0.5,
-               ssd = sl3*sl7/t1_,
-               sse = ( t2_-w1_ )*( w4_-MX2_ )+( t2_-w4_+w31_ )*( ( t2_-w1_)*MX2_-(w4_-MX2_)*w1_)/t1_;
-
-  double s1pp, s1pm;
-  if (ssb/ssd>=0.) { s1pp = ssb+ssd; s1pm = sse/s1pp; }
-  else             { s1pm = ssb-ssd; s1pp = sse/s1pm; } // 16
-  // 17
-  dd4_ = -t1_*( s1_-s1pp )*( s1_-s1pm ) * 0.25;
-  //const double acc4 = ( s1_-s1pm )/( s1_+s1pm );
-  dd5_ = dd1_+dd3_+( ( p12_*( t1_-w31_ )*0.5-w1_*p2k1_ )*( p2k1_*( t2_-w52_ )-w2_*r3 )-delta_*( 2.*p12_*p2k1_-w2_*( t1_-w31_ ) ) ) / p2k1_;
-
-  return true;
+  t1_min = Simd::select( t1_min > -cuts_.q2_min, Simd::broadcast<V>( -cuts_.q2_min ), t1_min );
+  return ok;
 }
 
-bool
-GamGamLL::orient()
+template<typename V> CepGen::Simd::Mask<V>
+GamGamLL::t2Range( const V& s2x, const V& t1, const V& w4, const V& my2, V& t2_min, V& t2_max ) const
 {
-  if ( !pickin() or jacobian_ == 0. ) { DebuggingInsideLoop( Form( "Pickin failed! Jacobian = %f", jacobian_ ) ); return false; }
-
-  const double re = 0.5 / sqs_;
-  ep1_ = re*( s_+w12_ );
-  ep2_ = re*( s_-w12_ );
-
-  DebuggingInsideLoop( Form( " re = %e\n\tw12_ = %e", re, w12_ ) );
-  DebuggingInsideLoop( Form( "Incoming particles' energy = %f, %f", ep1_, ep2_ ) );
-
-  p_cm_ = re*sl1_;
-
-  de3_ = re*(s2_-MX2_+w12_);
-  de5_ = re*(s1_-MY2_-w12_);
-
-  // Final state energies
-  const double ep3 = ep1_-de3_,
-               ep5 = ep2_-de5_;
-  ec4_ = de3_+de5_;
-
-  if ( ec4_ < mc4_ ) { InWarning( Form( "ec4_ = %f < mc4_ = %f\n\t==> de3 = %f, de5 = %f", ec4_, mc4_, de3_, de5_ ) ); return false; }
-
-  // What if the protons' momenta are not along the z-axis?
-  pc4_ = sqrt( ec4_*ec4_-mc4_*mc4_ );
-
-  if ( pc4_==0. ) {
-    InWarning( "pzc4==0" );
-    return false;
-  }
-
-  const double pp3 = sqrt( ep3*ep3-MX2_ ), pt3 = sqrt( dd1_/s_ )/p_cm_,
-               pp5 = sqrt( ep5*ep5-MY2_ ), pt5 = sqrt( dd3_/s_ )/p_cm_;
-
-  DebuggingInsideLoop( Form( "Central system's energy: E4 = %f\n\t"
-                             "                 momentum: p4 = %f\n\t"
-                             "                 invariant mass: m4 = %f\n\t"
-                             "Outgoing particles' energy: E3 = %f\n\t"
-                             "                            E5 = %f",
-                             ec4_, pc4_, mc4_, ep3, ep5 ) );
-
-  const double sin_theta3 = pt3/pp3,
-               sin_theta5 = pt5/pp5;
-
-  DebuggingInsideLoop( Form( "sin_theta3 = %e\n\tsin_theta5 = %e", sin_theta3, sin_theta5 ) );
-
-  if (sin_theta3>1.) { InWarning( Form( "sin_theta3 = %e > 1", sin_theta3 ) ); return false; }
-  if (sin_theta5>1.) { InWarning( Form( "sin_theta5 = %e > 1", sin_theta5 ) ); return false; }
+  const V d6 = w4-my2,
+          d8 = t1-w2_,
+          dd4 = w4-t1,
+          w52 = my2-w2_;
+  const V r1 = s2x-d8,
+          r2 = s2x-d6;
 
-  double ct3 = sqrt( 1.-sin_theta3*sin_theta3 ),
-         ct5 = sqrt( 1.-sin_theta5*sin_theta5 );
+  const V rl4 = ( r1*r1-4.*w2_*s2x )*( r2*r2-4.*my2*s2x );
+  const V sl4 = Simd::sqrt( rl4 );
 
-  if ( ep1_*ep3 < p13_ ) ct3 *= -1.;
-  if ( ep2_*ep5 > p25_ ) ct5 *= -1.;
-
-  DebuggingInsideLoop( Form( "ct3 = %e\n\tct5 = %e", ct3, ct5 ) );
-
-  if ( dd5_ < 0. ) { InWarning( Form( "dd5 = %f < 0", dd5_ ) ); return false; }
-
-  // Centre of mass system kinematics (theta4 and phi4)
-  pt4_ = sqrt( dd5_/s_ )/p_cm_;
-  sin_theta4_ = pt4_/pc4_;
-
-  if ( sin_theta4_ > 1. ) { InWarning( Form( "st4 = %f > 1", sin_theta4_ ) ); return false; }
-
-  cos_theta4_ = sqrt( 1.-sin_theta4_*sin_theta4_ );
-  if ( ep1_*ec4_ < p14_ ) cos_theta4_ *= -1.;
-
-  al4_ = 1.-cos_theta4_;
-  be4_ = 1.+cos_theta4_;
-
-  if (cos_theta4_<0.) be4_ = sin_theta4_*sin_theta4_/al4_;
-  else                al4_ = sin_theta4_*sin_theta4_/be4_;
-
-  DebuggingInsideLoop( Form( "ct4 = %f\n\tal4 = %f, be4 = %f", cos_theta4_, al4_, be4_ ) );
-
-  const double rr  = sqrt( -gram_/s_ )/( p_cm_*pt4_ );
-  const double sin_phi3 =  rr / pt3,
-               sin_phi5 = -rr / pt5;
-
-  if ( fabs( sin_phi3 ) > 1. ) { InWarning( Form( "sin(phi_3) = %e while it must be in [-1 ; 1]", sin_phi3 ) ); return false; }
-  if ( fabs( sin_phi5 ) > 1. ) { InWarning( Form( "sin(phi_5) = %e while it must be in [-1 ; 1]", sin_phi5 ) ); return false; }
-
-  const double cos_phi3 = -sqrt( 1.-sin_phi3*sin_phi3 ),
-               cos_phi5 = -sqrt( 1.-sin_phi5*sin_phi5 );
-
-  p3_lab_ = Particle::Momentum( pp3*sin_theta3*cos_phi3, pp3*sin_theta3*sin_phi3, pp3*ct3, ep3 );
-  p5_lab_ = Particle::Momentum( pp5*sin_theta5*cos_phi5, pp5*sin_theta5*sin_phi5, pp5*ct5, ep5 );
-
-  const double a1 = p3_lab_.px()-p5_lab_.px();
-
-  DebuggingInsideLoop( Form( "Kinematic quantities\n\t"
-                             "cos(theta3) = %1.4f\tsin(theta3) = %1.4f\tcos( phi3 ) = %1.4f\tsin( phi3 ) = %1.4f\n\t"
-                             "cos(theta4) = %1.4f\tsin(theta4) = %1.4f\n\t"
-                             "cos(theta5) = %1.4f\tsin(theta5) = %1.4f\tcos( phi5 ) = %1.4f\tsin( phi5 ) = %1.4f\n\t"
-                             "a1 = %f",
-                             ct3, sin_theta3, cos_phi3, sin_phi3,
-                             cos_theta4_, sin_theta4_,
-                             ct5, sin_theta5, cos_phi5, sin_phi5, a1 ) );
-
-  if ( fabs( pt4_+p3_lab_.px()+p5_lab_.px() ) < fabs( fabs( a1 )-pt4_ ) ) {
-    DebuggingInsideLoop( Form( "|pp4+pp3*cos(phi3)+pp5*cos(phi5)| < | |a1|-pp4 |\n\t"
-                               "pp4 = %f\tpp5 = %f\n\t"
-                               "cos(phi3) = %f\tcos(phi5) = %f"
-                               "a1 = %f",
-                               pt4_, pt5, cos_phi3, cos_phi5, a1 ) );
-    return true;
-  }
-  if ( a1 < 0. ) p5_lab_.setP( 0, -p5_lab_.px() );
-  else           p3_lab_.setP( 0, -p3_lab_.px() );
-  return true;
+  // t2max, t2min definitions from eq. (A.12) and (A.13) in [1]
+  t2_max = w2_+my2-( r1*r2+sl4 )/s2x * 0.5;
+  t2_min = ( w52*dd4+( dd4-w52 )*( dd4*w2_-w52*t1 )/s2x )/t2_max;
+  return ( rl4 > 0. );
 }
 
 double
@@ -464,22 +136,14 @@ GamGamLL::beforeComputeWeight()
   const Particle& p1 = event_->getOneByRole( Particle::IncomingBeam1 ),
                  &p2 = event_->getOneByRole( Particle::IncomingBeam2 );
 
-  ep1_ = p1.energy();
-  ep2_ = p2.energy();
-
-  const double thetamin = etaToTheta( cuts_.eta_max ),
-               thetamax = etaToTheta( cuts_.eta_min );
-  cot_theta1_ = 1./tan( thetamax*M_PI/180. );
-  cot_theta2_ = 1./tan( thetamin*M_PI/180. );
-  DebuggingInsideLoop( Form( "cot(theta1) = %f\n\tcot(theta2) = %f", cot_theta1_, cot_theta2_ ) );
-
-  Ml12_ = event_->getOneByRole( Particle::CentralParticle1 ).mass2();
-  Ml22_ = event_->getOneByRole( Particle::CentralParticle2 ).mass2();
+  // the angular cuts and the central particles' masses are fixed for the run (see prepareKinematics)
 
   switch ( cuts_.mode ) {
     case Kinematics::ElectronProton: default:
       { InError( "Case not yet supported!" ); } break;
     case Kinematics::ElasticElastic:
+      event_->getOneByRole( Particle::OutgoingBeam1 ).setMass( Particle::massFromPDGId( p1.pdgId() ) );
+      event_->getOneByRole( Particle::OutgoingBeam2 ).setMass( Particle::massFromPDGId( p2.pdgId() ) );
       dw31_ = dw52_ = 0.; break;
     case Kinematics::InelasticElastic: {
       const double m = computeOutgoingPrimaryParticlesMasses( x( 7 ), p1.mass(), sqrt( Ml12_ ), dw31_ );
@@ -500,271 +164,617 @@ GamGamLL::beforeComputeWeight()
   }
   MX_ = event_->getOneByRole( Particle::OutgoingBeam1 ).mass();
   MY_ = event_->getOneByRole( Particle::OutgoingBeam2 ).mass();
-  MX2_ = MX_*MX_;
-  MY2_ = MY_*MY_;
 }
 
-double
-GamGamLL::computeWeight()
+std::string
+GamGamLL::settings() const
 {
-  if ( !is_outgoing_state_set_ ) { InWarning( "Output state not set!" ); return 0.; }
+  if ( !implemented( n_opt_ ) ) {
+    throw Exception( __PRETTY_FUNCTION__, Form( "Phase space mapping optimisation nopt = %d not implemented!", n_opt_ ), FatalError );
+  }
+  if ( n_opt_ == 0 ) return "";
+  return Form( "nopt=%d", n_opt_ );
+}
 
-  DebuggingInsideLoop( Form( "sqrt(s)=%f\n\tm(X1)=%f\tm(X2)=%f", sqs_, MX_, MY_ ) );
+void
+GamGamLL::prepareKinematics()
+{
+  GenericProcess::prepareKinematics();
+  if ( !is_kinematics_set_ ) return;
 
-  if ( cuts_.w_max < 0 ) cuts_.w_max = s_;
+  //--- incoming state
+  w12_ = w1_-w2_;
+  ss_ = s_+w12_;
+  const double rl1 = ss_*ss_-4.*w1_*s_; // lambda(s, m1**2, m2**2)
+  sl1_ = ( rl1 > 0. ) ? sqrt( rl1 ) : 0.;
+  const double re = 0.5 / sqs_;
+  ep1_ = re*( s_+w12_ );
+  ep2_ = re*( s_-w12_ );
+  p_cm_ = re*sl1_;
+  p12_ = ( s_-w1_-w2_ )*0.5;
+  DebuggingInsideLoop( Form( "Incoming particles' energy = %f, %f", ep1_, ep2_ ) );
+
+  //--- angular cuts on the outgoing leptons
+  const double thetamin = etaToTheta( cuts_.eta_max ),
+               thetamax = etaToTheta( cuts_.eta_min );
+  cot_theta1_ = 1./tan( thetamax*M_PI/180. );
+  cot_theta2_ = 1./tan( thetamin*M_PI/180. );
+  DebuggingInsideLoop( Form( "cot(theta1) = %f\n\tcot(theta2) = %f", cot_theta1_, cot_theta2_ ) );
+
+  //--- on-shell masses (the event record holds the ones computed from the momenta of the previous event)
+  Ml12_ = std::pow( Particle::massFromPDGId( event_->getOneByRole( Particle::CentralParticle1 ).pdgId() ), 2 );
+  Ml22_ = std::pow( Particle::massFromPDGId( event_->getOneByRole( Particle::CentralParticle2 ).pdgId() ), 2 );
 
+  //--- two-photon system mass range
+  if ( cuts_.w_max < 0 ) cuts_.w_max = s_;
   // The minimal energy for the central system is its outgoing leptons' mass energy (or wmin_ if specified)
-  const double wmin = std::max( std::pow( sqrt( Ml12_ ) + sqrt( Ml22_ ), 2 ), cuts_.w_min );
+  w4_min_ = std::max( std::pow( sqrt( Ml12_ ) + sqrt( Ml22_ ), 2 ), cuts_.w_min );
+  // The maximal one only depends on the point for dissociative protons
+  const double mx = Particle::massFromPDGId( event_->getOneByRole( Particle::IncomingBeam1 ).pdgId() ),
+               my = Particle::massFromPDGId( event_->getOneByRole( Particle::IncomingBeam2 ).pdgId() );
+  w4_range_ = std::min( std::pow( sqs_-mx-my, 2 ), cuts_.w_max )/w4_min_;
+  log_w4_range_ = log( w4_range_ );
+  DebuggingInsideLoop( Form( "wmin = %f\n\twmax/wmin = %f", w4_min_, w4_range_ ) );
+}
 
-  // The maximal energy for the central system is its CM energy with the outgoing particles' mass energy substracted (or _wmax if specified)
-  const double wmax = std::min( std::pow( sqs_-MX_-MY_, 2 ), cuts_.w_max );
+void
+GamGamLL::setKinematics( const Kinematics& kin )
+{
+  GenericProcess::setKinematics( kin );
+  selectWeightComputation();
+}
 
-  DebuggingInsideLoop( Form( "wmin = %f\n\twmax = %f\n\twmax/wmin = %f", wmin, wmax, wmax/wmin ) );
+void
+GamGamLL::selectWeightComputation()
+{
+  //--- the Fiore valence/sea modellings share the same form factors
+  StructureFunctions sf = SuriYennie;
+  switch ( cuts_.remnant_mode ) {
+    case Fiore: case FioreSea: case FioreVal: sf = Fiore; break;
+    case SzczurekUleshchenko: sf = SzczurekUleshchenko; break;
+    case SuriYennie: default: break;
+  }
+  switch ( cuts_.mode ) {
+    case Kinematics::ElectronProton: default:
+      setWeightComputation<Kinematics::ElectronProton,SuriYennie>(); break;
+    case Kinematics::ElasticElastic:
+      setWeightComputation<Kinematics::ElasticElastic,SuriYennie>(); break;
+    case Kinematics::InelasticElastic:
+      if ( sf == Fiore )                    setWeightComputation<Kinematics::InelasticElastic,Fiore>();
+      else if ( sf == SzczurekUleshchenko ) setWeightComputation<Kinematics::InelasticElastic,SzczurekUleshchenko>();
+      else                                  setWeightComputation<Kinematics::InelasticElastic,SuriYennie>();
+      break;
+    case Kinematics::ElasticInelastic:
+      if ( sf == Fiore )                    setWeightComputation<Kinematics::ElasticInelastic,Fiore>();
+      else if ( sf == SzczurekUleshchenko ) setWeightComputation<Kinematics::ElasticInelastic,SzczurekUleshchenko>();
+      else                                  setWeightComputation<Kinematics::ElasticInelastic,SuriYennie>();
+      break;
+    case Kinematics::InelasticInelastic:
+      if ( sf == Fiore )                    setWeightComputation<Kinematics::InelasticInelastic,Fiore>();
+      else if ( sf == SzczurekUleshchenko ) setWeightComputation<Kinematics::InelasticInelastic,SzczurekUleshchenko>();
+      else                                  setWeightComputation<Kinematics::InelasticInelastic,SuriYennie>();
+      break;
+  }
+}
 
-  // compute the two-photon energy for this point
-  w4_ = 0.;
-  double dw4 = 0.;
-  Map( x( 4 ), wmin, wmax, w4_, dw4, "w4" );
-  Map( x( 4 ), wmin, wmax, w4_, dw4, "w4" );
-  mc4_ = sqrt( w4_ );
+template<CepGen::Kinematics::ProcessMode mode, CepGen::StructureFunctions sf> void
+GamGamLL::setWeightComputation()
+{
+  compute_weight_ = &GamGamLL::computeWeight<mode,sf>;
+  compute_weights_ = &GamGamLL::computeBlockWeights<mode,sf>;
+}
 
-  DebuggingInsideLoop( Form( "Computed value for w4 = %f -> mc4 = %f", w4_, mc4_ ) );
+template<CepGen::Kinematics::ProcessMode mode, CepGen::StructureFunctions sf, typename V> V
+GamGamLL::computeLanes( const V* x, const V& mx, const V& my, const V& dmx, const V& dmy, int nopt, Outgoing<V>* out )
+{
+  ProfileRegion( "lanes" );
+  const bool inel_p1 = ( mode == Kinematics::InelasticElastic || mode == Kinematics::InelasticInelastic ),
+             inel_p2 = ( mode == Kinematics::ElasticInelastic || mode == Kinematics::InelasticInelastic );
+  const V zero = Simd::broadcast<V>( 0. ), one = Simd::broadcast<V>( 1. );
 
-  if ( !orient() ) return 0.;
+  // sqrt(lambda(s, m1**2, m2**2)) and s+m1**2-m2**2 are computed once for the run (see prepareKinematics)
+  if ( sl1_ <= 0. ) { InWarning( Form( "rl1 = %f <= 0", ss_*ss_-4.*w1_*s_ ) ); return zero; }
 
-  if ( jacobian_ == 0. ) { InWarning( Form( "dj = %f", jacobian_ ) ); return 0.; }
+  const V mx2 = mx*mx, my2 = my*my;
+  // mass difference between the first (second) outgoing particle and the first (second) incoming particle
+  const V w31 = mx2-w1_, w52 = my2-w2_;
 
-  if ( t1_>0. )  { InWarning( Form( "t1 = %f > 0", t1_ ) ); return 0.; }
-  if ( t2_>0. )  { InWarning( Form( "t2 = %f > 0", t2_ ) ); return 0.; }
+  //--- two-photon system mass (its range is only fixed for the run with elastic protons, see prepareKinematics)
 
-  const double ecm6 = ( w4_+Ml12_-Ml22_ ) / ( 2.*mc4_ ),
-               pp6cm = sqrt( ecm6*ecm6-Ml12_ );
+  V w4m, dw4;
+  if ( mode == Kinematics::ElasticElastic ) {
+    w4m = w4_min_*Simd::exp( x[4]*log_w4_range_ );
+    dw4 = w4m*log_w4_range_;
+  }
+  else {
+    // the maximal energy for the central system is its CM energy with the outgoing particles' mass energy substracted (or wmax if specified)
+    const V sqw = sqs_-mx-my;
+    mapLanes( x[4], Simd::broadcast<V>( w4_min_ ), Simd::min( sqw*sqw, Simd::broadcast<V>( cuts_.w_max ) ), w4m, dw4 );
+  }
+  const V mc4 = Simd::sqrt( w4m ), w4 = mc4*mc4;
 
-  jacobian_ *= dw4*pp6cm/( mc4_*Constants::sconstb*s_ );
+  //--- Lorentz-invariant description of the 2 -> 3 kinematics (pickin in LPAIR)
 
-  // Let the most obscure part of this code begin...
+  // sig1 = sigma and sig2 = sigma' in [1]
+  const V sig = mc4+my, sig1 = sig*sig;
+  V sig2 = sig1;
+  // mass difference between the central two-photons system and the second outgoing particle
+  const V d6 = w4-my2;
 
-  const double e1mp1 = w1_ / ( ep1_+p_cm_ ),
-               e3mp3 = MX2_ / ( p3_lab_.energy()+p3_lab_.p() );
+  const V smax = s_+mx2-2.*mx*sqs_;
+  V s2 = zero, ds2 = zero;
+  if ( nopt == 0 ) mapLanes( x[2], sig1, smax, s2, ds2 );
 
-  const double al3 = std::pow( sin( p3_lab_.theta() ), 2 )/( 1.+( p3_lab_.theta() ) );
+  // t1, the first photon propagator, is defined here
+  V t1_min, t1_max;
+  Simd::Mask<V> ok = t1Range( ( nopt == 0 ) ? s2 : sig1, mx2, t1_min, t1_max );
+  V t1, dt1;
+  mapLanes( x[0], t1_min, t1_max, t1, dt1 );
+  // changes wrt mapt1 : dx->-dx
+  dt1 = -dt1;
 
-  // 2-photon system kinematics ?!
-  const double eg = ( w4_+t1_-t2_ )/( 2.*mc4_ );
-  double pg = sqrt( eg*eg-t1_ );
+  const V d8 = t1-w2_,
+          t13 = t1-w1_-mx2;
 
-  const double pgx = -p3_lab_.px()*cos_theta4_-sin_theta4_*( de3_-e1mp1 + e3mp3 + p3_lab_.p()*al3 ),
-               pgy = -p3_lab_.py(),
-               pgz = mc4_*de3_/( ec4_+pc4_ )-ec4_*de3_*al4_/mc4_-p3_lab_.px()*ec4_*sin_theta4_/mc4_+ec4_*cos_theta4_/mc4_*( p3_lab_.p()*al3+e3mp3-e1mp1 );
+  const V sa1 = -0.25*( t1-w31 )*( t1-w31 )+w1_*t1;
+  const V sl3 = Simd::sqrt( -sa1 );
 
-  DebuggingInsideLoop( Form( "pg3 = (%f, %f, %f)\n\t"
-                             "pg3^2 = %f",
-                             pgx, pgy, pgz,
-                             sqrt( pgx*pgx+pgy*pgy+pgz*pgz ) ) );
+  // one computes splus and (s2x=s2max)
+  V splus, s2max;
+  if ( w1_ != 0. ) {
+    const V sb = ( s_*( t1-w31 )+w12_*t13 )/( 2.*w1_ )+mx2,
+            sd = sl1_*sl3/w1_,
+            se = ( s_*( t1*( s_+t13-w2_ )-w2_*w31 )+mx2*( w12_*d8+w2_*mx2 ) )/w1_;
+    const Simd::Mask<V> low = ( Simd::abs( ( sb-sd )/sd ) >= 1. );
+    splus = Simd::select( low, sb-sd, se/( sb+sd ) );
+    s2max = Simd::select( low, se/( sb-sd ), sb+sd );
+  }
+  else {
+    s2max = ( s_*( t1*( s_+d8-mx2 )-w2_*mx2 )+w2_*mx2*( w2_+mx2-t1 ) )/( ss_*t13 );
+    splus = sig2;
+  }
+  V s2x = s2max;
+  if ( nopt < 0 ) {
+    sig2 = Simd::select( splus > sig2, splus, sig2 );
+    if ( nopt < -1 ) mapLanes( x[2], sig2, s2max, s2, ds2 );
+    else             maplaLanes( t1, w2_, x[2], sig2, s2max, s2, ds2 ); // nopt==-1
+    s2x = s2;
+  }
+  else if ( nopt == 0 ) s2x = s2;
 
-  const double pgp = sqrt( pgx*pgx + pgy*pgy ), // outgoing proton (3)'s transverse momentum
-               pgg = sqrt( pgp*pgp + pgz*pgz ); // outgoing proton (3)'s momentum
-  if ( pgg > pgp*0.9 && pgg > pg ) { pg = pgg; } //FIXME ???
+  // t2, the second photon propagator, is defined here
+  V t2_min, t2_max;
+  ok = ok && ( sa1 < 0. ) && t2Range( s2x, t1, w4, my2, t2_min, t2_max );
+  V t2, dt2;
+  mapLanes( x[1], t2_min, t2_max, t2, dt2 );
+  // changes wrt mapt2 : dx->-dx
+  dt2 = -dt2;
 
-  // Phi angle for the 2-photon system ?!
-  const double cpg = pgx/pgp,
-               spg = pgy/pgp;
+  const V tau = t1-t2,
+          r3 = w4-t1-t2,
+          r4 = w52-t2;
 
-  // Theta angle for the 2-photon system ?!
-  const double stg = pgp/pg;
+  const V b = r3*r4-2.*( t1+w2_ )*t2,
+          c = t2*d6*d8+( d6-d8 )*( d6*w2_-d8*my2 );
 
-  const int theta_sign = ( pgz>0. ) ? 1 : -1;
-  const double ctg = theta_sign*sqrt( 1.-stg*stg );
+  const V t25 = t2-w2_-my2;
 
-  double xx6 = x( 5 );
+  const V sa2 = -0.25*r4*r4+w2_*t2,
+          g4 = -0.25*r3*r3+t1*t2;
+  const V sl6 = 2.*Simd::sqrt( -sa2 ),
+          sl7 = 2.*Simd::sqrt( -g4 ),
+          sl5 = sl6*sl7;
 
-  const double amap = 0.5 * (w4_-t1_-t2_),
-               bmap = 0.5 * sqrt( ( std::pow( w4_-t1_-t2_, 2 )-4.*t1_*t2_ )*( 1.-4.*Ml12_/w4_ ) ),
-               ymap = ( amap+bmap )/( amap-bmap ),
-               beta = std::pow( ymap, 2.*xx6-1. );
-  xx6 = 0.5 * ( 1. + amap/bmap*( beta-1. )/( beta+1. ) );
-  xx6 = std::max( 0., std::min( xx6, 1. ) ); // xx6 in [0., 1.]
+  const Simd::Mask<V> low_s2p = ( Simd::abs( ( sl5-b )/sl5 ) >= 1. );
+  const V s2p_high = ( sl5-b )/t2*0.5, s2min_low = ( -sl5-b )/t2*0.5;
+  const V s2p = Simd::select( low_s2p, s2p_high, c/( t2*s2min_low ) ),
+          s2min = Simd::select( low_s2p, c/( t2*s2p_high ), s2min_low );
+  if ( nopt > 1 )       mapLanes( x[2], s2min, s2max, s2, ds2 );
+  else if ( nopt == 1 ) maplaLanes( t1, w2_, x[2], s2min, s2max, s2, ds2 );
 
-  DebuggingInsideLoop( Form( "amap = %f\n\tbmap = %f\n\tymap = %f\n\tbeta = %f", amap, bmap, ymap, beta ) );
+  const V ap = -0.25*( s2+d8 )*( s2+d8 )+s2*t1;
 
-  // 3D rotation of the first outgoing lepton wrt the CM system
-  const double theta6cm = acos( 1.-2.*xx6 );
+  const V dd1 = ( w1_ != 0. ) ? -0.25*( s2-s2max )*( s2-splus )*w1_ : 0.25*( s2-s2max )*ss_*t13;
+  const V dd2 = -t2*( s2-s2p )*( s2-s2min )*0.25;
 
-  // match the Jacobian
-  jacobian_ *= ( amap+bmap*cos( theta6cm ) );
-  jacobian_ *= ( amap-bmap*cos( theta6cm ) );
-  jacobian_ /= amap;
-  jacobian_ /= bmap;
-  jacobian_ *= log( ymap );
-  jacobian_ *= 0.5;
+  const V yy4 = Simd::cos( M_PI*x[3] );
+  const V dd = dd1*dd2;
+  const V st = s2-t1-w2_;
+  const V delb = ( 2.*w2_*r3+r4*st )*( 4.*p12_*t1-( t1-w31 )*st )/( 16.*ap );
 
-  DebuggingInsideLoop( Form( "Jacobian = %e", jacobian_ ) );
+  // invariant used to tame divergences in the matrix element computation,
+  // Delta = (p1.p2)(q1.q2)-(p1.q2)(p2.q1), with p_i and q_i the incoming proton-like particles and their photons
+  const V delta = delb-yy4*st*Simd::sqrt( dd )/ap*0.5;
+  const V s1 = t2+w1_+( 2.*p12_*r3-4.*delta )/st;
 
-  DebuggingInsideLoop( Form( "ctcm6 = %f\n\tstcm6 = %f", cos( theta6cm ), sin( theta6cm ) ) );
+  ok = ok && ( sa2 < 0. ) && ( g4 < 0. ) && ( dd > 0. ) && ( ap < 0. );
+  if ( !Simd::any( ok ) ) return zero;
 
-  const double phi6cm = 2.*M_PI*x( 6 );
+  const V jacobian = ds2*dt1*dt2*M_PI*M_PI/( 8.*sl1_*Simd::sqrt( -ap ) );
 
-  // First outgoing lepton's 3-momentum in the centre of mass system
-  Particle::Momentum p6cm = Particle::Momentum::fromPThetaPhi( pp6cm, theta6cm, phi6cm );
+  const V gram = ( 1.-yy4*yy4 )*dd/ap;
 
-  DebuggingInsideLoop( Form( "p3cm6 = (%f, %f, %f)", p6cm.px(), p6cm.py(), p6cm.pz() ) );
+  const V p13 = -t13*0.5,
+          p14 = ( tau+s1-mx2 )*0.5,
+          p25 = -t25*0.5;
+  const V p1k2 = ( s1-t2-w1_ )*0.5,
+          p2k1 = st*0.5;
 
-  const double h1 = stg*p6cm.pz()+ctg*p6cm.px();
-  const double pc6z = ctg*p6cm.pz()-stg*p6cm.px(), pc6x = cpg*h1-spg*p6cm.py();
+  V dd3;
+  if ( w2_ != 0. ) {
+    const V sbb = ( s_*( t2-w52 )-w12_*t25 )/w2_*0.5+my2,
+            sdd = sl1_*sl6/w2_*0.5,
+            see = ( s_*( t2*( s_+t25-w1_ )-w1_*w52 )+my2*( w1_*my2-w12_*( t2-w1_ ) ) )/w2_;
+    const Simd::Mask<V> pos = ( sbb/sdd >= 0. );
+    const V s1p = Simd::select( pos, sbb+sdd, see/( sbb-sdd ) ),
+            s1m = Simd::select( pos, see/( sbb+sdd ), sbb-sdd );
+    dd3 = -w2_*( s1p-s1 )*( s1m-s1 )*0.25;
+  }
+  else {
+    const V s1p = ( s_*( t2*( s_-my2+t2-w1_ )-w1_*my2 )+w1_*my2*( w1_+my2-t2 ) )/( t25*( s_-w12_ ) );
+    dd3 = -t25*( s_-w12_ )*( s1p-s1 )*0.25;
+  }
 
-  const double qcx = 2.*pc6x, qcz = 2.*pc6z;
-  // qcy == QCY is never defined
+  const V ssb = t2+w1_-r3*( w31-t1 )/t1*0.5,
+          ssd = sl3*sl7/t1,
+          sse = ( t2-w1_ )*( w4-mx2 )+( t2-w4+w31 )*( ( t2-w1_ )*mx2-( w4-mx2 )*w1_ )/t1;
+  const Simd::Mask<V> pos_s1 = ( ssb/ssd >= 0. );
+  const V s1pp = Simd::select( pos_s1, ssb+ssd, sse/( ssb-ssd ) ),
+          s1pm = Simd::select( pos_s1, sse/( ssb+ssd ), ssb-ssd );
+  // delta_5 = m4**2-t1 in [1]
+  const V dd4 = -t1*( s1-s1pp )*( s1-s1pm )*0.25;
+  const V dd5 = dd1+dd3+( ( p12_*( t1-w31 )*0.5-w1_*p2k1 )*( p2k1*( t2-w52 )-w2_*r3 )-delta*( 2.*p12_*p2k1-w2_*( t1-w31 ) ) )/p2k1;
 
-  const double el6 = ( ec4_*ecm6+pc4_*pc6z ) / mc4_,
-               h2  = ( ec4_*pc6z+pc4_*ecm6 ) / mc4_;
+  //--- energies and momenta of the particles in the centre of mass frame (orient in LPAIR)
 
-  DebuggingInsideLoop( Form( "h1 = %f\n\th2 = %f", h1, h2 ) );
+  // the incoming particles' energies and momentum are computed once for the run (see prepareKinematics)
+  const double re = 0.5/sqs_;
+  const V de3 = re*( s2-mx2+w12_ ),
+          de5 = re*( s1-my2-w12_ );
 
-  // First outgoing lepton's 3-momentum
-  const double p6x = cos_theta4_*pc6x+sin_theta4_*h2,
-               p6y = cpg*p6cm.py()+spg*h1,
-               p6z = cos_theta4_*h2-sin_theta4_*pc6x;
+  // final state energies
+  const V ep3 = ep1_-de3,
+          ep5 = ep2_-de5,
+          ec4 = de3+de5;
 
-  // first outgoing lepton's kinematics
-  p6_cm_ = Particle::Momentum( p6x, p6y, p6z, el6 );
-  DebuggingInsideLoop( Form( "E6(cm) = %f\n\tP6(cm) = (%f, %f, %f)", el6, p6x, p6y, p6z ) );
+  const V pc4 = Simd::sqrt( ec4*ec4-w4 );
 
-  const double hq = ec4_*qcz/mc4_;
+  const V pp3 = Simd::sqrt( ep3*ep3-mx2 ), pt3 = Simd::sqrt( dd1/s_ )/p_cm_,
+          pp5 = Simd::sqrt( ep5*ep5-my2 ), pt5 = Simd::sqrt( dd3/s_ )/p_cm_;
 
-  const Particle::Momentum qve(
-    cos_theta4_*qcx+sin_theta4_*hq,
-    2.*p6y,
-    cos_theta4_*hq-sin_theta4_*qcx,
-    pc4_*qcz/mc4_ // energy
-  );
+  const V sin_theta3 = pt3/pp3,
+          sin_theta5 = pt5/pp5;
+  const V ct3 = Simd::sqrt( 1.-sin_theta3*sin_theta3 ),
+          ct5 = Simd::sqrt( 1.-sin_theta5*sin_theta5 );
+  const V cos_theta3 = Simd::select( ep1_*ep3 < p13, -ct3, ct3 ),
+          cos_theta5 = Simd::select( ep2_*ep5 > p25, -ct5, ct5 );
 
-  // Available energy for the second lepton is the 2-photon system's energy with the first lepton's energy removed
-  const double el7 = ec4_-el6;
+  // centre of mass system kinematics (theta4 and phi4)
+  const V pt4 = Simd::sqrt( dd5/s_ )/p_cm_;
+  const V sin_theta4 = pt4/pc4;
+  const V ct4 = Simd::sqrt( 1.-sin_theta4*sin_theta4 );
+  const V cos_theta4 = Simd::select( ep1_*ec4 < p14, -ct4, ct4 );
+  const V al4 = Simd::select( cos_theta4 < 0., 1.-cos_theta4, sin_theta4*sin_theta4/( 1.+cos_theta4 ) );
 
-  DebuggingInsideLoop( Form( "Outgoing kinematics\n\t"
-                             " first outgoing lepton: p = %f, E = %f\n\t"
-                             "second outgoing lepton: p = %f, E = %f",
-                             p6_cm_.p(), p6_cm_.energy(), p7_cm_.p(), p6_cm_.energy() ) );
+  const V rr = Simd::sqrt( -gram/s_ )/( p_cm_*pt4 );
+  const V sin_phi3 = rr/pt3,
+          sin_phi5 = -rr/pt5;
+  const V cos_phi3 = -Simd::sqrt( 1.-sin_phi3*sin_phi3 ),
+          cos_phi5 = -Simd::sqrt( 1.-sin_phi5*sin_phi5 );
 
-  // Second outgoing lepton's 3-momentum
-  const double p7x = -p6x + pt4_,
-               p7y = -p6y,
-               p7z = -p6z + pc4_*cos_theta4_;
+  V p3x = pp3*sin_theta3*cos_phi3, p5x = pp5*sin_theta5*cos_phi5;
+  const V p3y = pp3*sin_theta3*sin_phi3, p3z = pp3*cos_theta3,
+          p5y = pp5*sin_theta5*sin_phi5, p5z = pp5*cos_theta5;
 
-  // second outgoing lepton's kinematics
-  p7_cm_ = Particle::Momentum( p7x, p7y, p7z, el7 );
+  const V a1 = p3x-p5x;
+  const Simd::Mask<V> flip = !( Simd::abs( pt4+p3x+p5x ) < Simd::abs( Simd::abs( a1 )-pt4 ) );
+  p5x = Simd::select( flip && ( a1 < 0. ), -p5x, p5x );
+  p3x = Simd::select( flip && !( a1 < 0. ), -p3x, p3x );
 
-  //p6_cm_ = Particle::Momentum(pl6*st6*cp6, pl6*st6*sp6, pl6*ct6, el6);
-  //p7_cm_ = Particle::Momentum(pl7*st7*cp7, pl7*st7*sp7, pl7*ct7, el7);
+  ok = ok && !( ec4 < mc4 ) && ( pc4 != 0. )
+          && !( sin_theta3 > 1. ) && !( sin_theta5 > 1. ) && !( dd5 < 0. ) && !( sin_theta4 > 1. )
+          && !( Simd::abs( sin_phi3 ) > 1. ) && !( Simd::abs( sin_phi5 ) > 1. )
+          && ( jacobian != 0. ) && !( t1 > 0. ) && !( t2 > 0. );
+  if ( !Simd::any( ok ) ) return zero;
 
-  q1dq_ = eg*( 2.*ecm6-mc4_ )-2.*pg*p6cm.pz();
-  q1dq2_ = ( w4_-t1_-t2_ ) * 0.5;
+  //--- outgoing leptons' kinematics
 
-  const double phi3 = p3_lab_.phi(), cos_phi3 = cos( phi3 ), sin_phi3 = sin( phi3 ),
-               phi5 = p5_lab_.phi(), cos_phi5 = cos( phi5 ), sin_phi5 = sin( phi5 );
+  const V ecm6 = ( w4+Ml12_-Ml22_ )/( 2.*mc4 ),
+          pp6cm = Simd::sqrt( ecm6*ecm6-Ml12_ );
 
-  bb_ = t1_*t2_+( w4_*std::pow( sin( theta6cm ), 2 ) + 4.*Ml12_*std::pow( cos( theta6cm ), 2 ) )*pg*pg;
+  V weight = jacobian*dw4*pp6cm/( mc4*Constants::sconstb*s_ );
 
-  const double c1 = p3_lab_.pt() * ( qve.px()*sin_phi3  - qve.py()*cos_phi3   ),
-               c2 = p3_lab_.pt() * ( qve.pz()*ep1_ - qve.energy() *p_cm_ ),
-               c3 = ( w31_*ep1_*ep1_ + 2.*w1_*de3_*ep1_ - w1_*de3_*de3_ + p3_lab_.pt2()*ep1_*ep1_ ) / ( p3_lab_.energy()*p_cm_ + p3_lab_.pz()*ep1_ );
+  // let the most obscure part of this code begin...
 
-  const double b1 = p5_lab_.pt() * ( qve.px()*sin_phi5  - qve.py()*cos_phi5   ),
-               b2 = p5_lab_.pt() * ( qve.pz()*ep2_ + qve.energy() *p_cm_ ),
-               b3 = ( w52_*ep2_*ep2_ + 2.*w2_*de5_*ep2_ - w2_*de5_*de5_ + p5_lab_.pt2()*ep2_*ep2_ ) / ( ep2_*p5_lab_.pz() - p5_lab_.energy()*p_cm_ );
+  const V pt3_2 = p3x*p3x+p3y*p3y, pt3l = Simd::sqrt( pt3_2 ), p3 = Simd::sqrt( pt3_2+p3z*p3z );
+  const double e1mp1 = w1_/( ep1_+p_cm_ );
+  const V e3mp3 = mx2/( ep3+p3 );
 
-  const double r12 =  c2*sin_phi3 + qve.py()*c3,
-               r13 = -c2*cos_phi3 - qve.px()*c3;
+  const V sin_th3 = Simd::select( p3 > 0., pt3l/p3, zero );
+  const V al3 = sin_th3*sin_th3/( 1.+Simd::atan2( pt3l, p3z ) );
 
-  const double r22 =  b2*sin_phi5 + qve.py()*b3,
-               r23 = -b2*cos_phi5 - qve.px()*b3;
+  // 2-photon system kinematics ?!
+  const V eg = ( w4+t1-t2 )/( 2.*mc4 );
+  V pg = Simd::sqrt( eg*eg-t1 );
+
+  const V pgx = -p3x*cos_theta4-sin_theta4*( de3-e1mp1+e3mp3+p3*al3 ),
+          pgy = -p3y,
+          pgz = mc4*de3/( ec4+pc4 )-ec4*de3*al4/mc4-p3x*ec4*sin_theta4/mc4+ec4*cos_theta4/mc4*( p3*al3+e3mp3-e1mp1 );
+
+  const V pgp = Simd::sqrt( pgx*pgx+pgy*pgy ), // outgoing proton (3)'s transverse momentum
+          pgg = Simd::sqrt( pgp*pgp+pgz*pgz ); // outgoing proton (3)'s momentum
+  pg = Simd::select( pgg > pgp*0.9 && pgg > pg, pgg, pg ); //FIXME ???
+
+  // phi and theta angles for the 2-photon system ?!
+  const V cpg = pgx/pgp,
+          spg = pgy/pgp;
+  const V stg = pgp/pg;
+  const V ctg_abs = Simd::sqrt( 1.-stg*stg );
+  const V ctg = Simd::select( pgz > 0., ctg_abs, -ctg_abs );
+
+  // polar angle of the first outgoing lepton in the centre of mass system, mapped as
+  //   cos(theta6) = -amap/bmap*tanh(u), with u = (2 x5-1) log(ymap)/2 and ymap = (amap+bmap)/(amap-bmap),
+  // written from rmap = sqrt(amap**2-bmap**2) and z = 2 min(x5, 1-x5) log(ymap)/2 = |u|-log(ymap)/2 as
+  //   1-|cos(theta6)| = rmap*sinh(z)/bmap/cosh(u),
+  // to avoid the cancellations around |cos(theta6)| = 1 (and amap = bmap, for light leptons)
+  const V w4mt = w4-t1-t2, dmap = w4mt*w4mt-4.*t1*t2;
+  const V amap = 0.5*w4mt,
+          bmap = 0.5*Simd::sqrt( dmap*( 1.-4.*Ml12_/w4 ) ),
+          rmap = Simd::sqrt( t1*t2+dmap*Ml12_/w4 ),
+          sqrt_ymap = ( amap+bmap )/rmap,
+          log_ymap = 2.*Simd::log( sqrt_ymap );
+  const Simd::Mask<V> backward = ( x[5] > 0.5 );
+  const V em1 = Simd::expm1( Simd::min( x[5], 1.-x[5] )*log_ymap ), // exp(z)-1
+          exp_u = sqrt_ymap/( em1+1. ),
+          cosh_u = 0.5*( exp_u+1./exp_u );
+  V one_m_cos = rmap*0.5*em1*( em1+2. )/( em1+1. )/( bmap*cosh_u );
+  one_m_cos = Simd::select( one_m_cos > 1., one, one_m_cos );
 
-  epsi_ = p12_*c1*b1 + r12*r22 + r13*r23;
+  // 3D rotation of the first outgoing lepton wrt the CM system
+  const V cos_theta6cm = Simd::select( backward, one_m_cos-1., 1.-one_m_cos ),
+          sin_theta6cm = Simd::sqrt( one_m_cos*( 2.-one_m_cos ) );
 
-  g5_ = w1_*c1*c1 + r12*r12 + r13*r13;
-  g6_ = w2_*b1*b1 + r22*r22 + r23*r23;
+  // match the Jacobian ((amap+bmap*cos(theta6))*(amap-bmap*cos(theta6)) = amap**2/cosh(u)**2)
+  weight *= amap/bmap/( cosh_u*cosh_u )*log_ymap*0.5;
 
-  a5_ = -( qve.px()*cos_phi3 + qve.py()*sin_phi3 )*p3_lab_.pt()*p1k2_-( ep1_*qve.energy()-p_cm_*qve.pz() )*( cos_phi3*cos_phi5 + sin_phi3*sin_phi5 )*p3_lab_.pt()*p5_lab_.pt() + ( de5_*qve.pz()+qve.energy()*( p_cm_+p5_lab_.pz() ) )*c3;
-  a6_ = -( qve.px()*cos_phi5 + qve.py()*sin_phi5 )*p5_lab_.pt()*p2k1_-( ep2_*qve.energy()+p_cm_*qve.pz() )*( cos_phi3*cos_phi5 + sin_phi3*sin_phi5 )*p3_lab_.pt()*p5_lab_.pt() + ( de3_*qve.pz()-qve.energy()*( p_cm_-p3_lab_.pz() ) )*b3;
+  V sin_phi6cm, cos_phi6cm;
+  Simd::sincos( 2.*M_PI*x[6], sin_phi6cm, cos_phi6cm );
 
-  DebuggingInsideLoop( Form( "a5 = %f\n\ta6 = %f", a5_, a6_ ) );
+  // first outgoing lepton's 3-momentum in the centre of mass system
+  const V p6cmx = pp6cm*sin_theta6cm*cos_phi6cm,
+          p6cmy = pp6cm*sin_theta6cm*sin_phi6cm,
+          p6cmz = pp6cm*cos_theta6cm;
 
-  ////////////////////////////////////////////////////////////////
-  // END of GAMGAMLL subroutine in the FORTRAN version
-  ////////////////////////////////////////////////////////////////
+  const V h1 = stg*p6cmz+ctg*p6cmx;
+  const V pc6z = ctg*p6cmz-stg*p6cmx, pc6x = cpg*h1-spg*p6cmy;
 
-  const Particle::Momentum cm = event_->getOneByRole( Particle::IncomingBeam1 ).momentum() + event_->getOneByRole( Particle::IncomingBeam2 ).momentum();
+  const V qcx = 2.*pc6x, qcz = 2.*pc6z;
+  // qcy == QCY is never defined
+
+  const V el6 = ( ec4*ecm6+pc4*pc6z )/mc4,
+          h2 = ( ec4*pc6z+pc4*ecm6 )/mc4;
+
+  // first and second outgoing leptons' kinematics (the available energy for the second one is
+  // the 2-photon system's energy with the first lepton's energy removed)
+  const V p6x = cos_theta4*pc6x+sin_theta4*h2,
+          p6y = cpg*p6cmy+spg*h1,
+          p6z = cos_theta4*h2-sin_theta4*pc6x;
+  const V el7 = ec4-el6,
+          p7x = pt4-p6x,
+          p7y = -p6y,
+          p7z = pc4*cos_theta4-p6z;
+
+  const V hq = ec4*qcz/mc4;
+  const V qvx = cos_theta4*qcx+sin_theta4*hq,
+          qvy = 2.*p6y,
+          qvz = cos_theta4*hq-sin_theta4*qcx,
+          qve = pc4*qcz/mc4;
+
+  const V q1dq = eg*( 2.*ecm6-mc4 )-2.*pg*p6cmz,
+          q1dq2 = ( w4-t1-t2 )*0.5;
+
+  const V pt5_2 = p5x*p5x+p5y*p5y, pt5l = Simd::sqrt( pt5_2 );
+  const V cos_phi3l = Simd::select( pt3l > 0., p3x/pt3l, one ), sin_phi3l = Simd::select( pt3l > 0., p3y/pt3l, zero ),
+          cos_phi5l = Simd::select( pt5l > 0., p5x/pt5l, one ), sin_phi5l = Simd::select( pt5l > 0., p5y/pt5l, zero );
+
+  const V bb = t1*t2+( w4*sin_theta6cm*sin_theta6cm+4.*Ml12_*cos_theta6cm*cos_theta6cm )*pg*pg;
+
+  const V c1 = pt3l*( qvx*sin_phi3l-qvy*cos_phi3l ),
+          c2 = pt3l*( qvz*ep1_-qve*p_cm_ ),
+          c3 = ( w31*ep1_*ep1_+2.*w1_*de3*ep1_-w1_*de3*de3+pt3_2*ep1_*ep1_ )/( ep3*p_cm_+p3z*ep1_ );
+
+  const V b1 = pt5l*( qvx*sin_phi5l-qvy*cos_phi5l ),
+          b2 = pt5l*( qvz*ep2_+qve*p_cm_ ),
+          b3 = ( w52*ep2_*ep2_+2.*w2_*de5*ep2_-w2_*de5*de5+pt5_2*ep2_*ep2_ )/( ep2_*p5z-ep5*p_cm_ );
+
+  const V r12 = c2*sin_phi3l+qvy*c3,
+          r13 = -c2*cos_phi3l-qvx*c3;
+
+  const V r22 = b2*sin_phi5l+qvy*b3,
+          r23 = -b2*cos_phi5l-qvx*b3;
+
+  const V epsi = p12_*c1*b1+r12*r22+r13*r23;
+
+  const V g5 = w1_*c1*c1+r12*r12+r13*r13,
+          g6 = w2_*b1*b1+r22*r22+r23*r23;
+
+  const V cos_phi35 = cos_phi3l*cos_phi5l+sin_phi3l*sin_phi5l;
+  const V a5 = -( qvx*cos_phi3l+qvy*sin_phi3l )*pt3l*p1k2-( ep1_*qve-p_cm_*qvz )*cos_phi35*pt3l*pt5l+( de5*qvz+qve*( p_cm_+p5z ) )*c3,
+          a6 = -( qvx*cos_phi5l+qvy*sin_phi5l )*pt5l*p2k1-( ep2_*qve+p_cm_*qvz )*cos_phi35*pt3l*pt5l+( de3*qvz-qve*( p_cm_-p3z ) )*b3;
 
   ////////////////////////////////////////////////////////////////
-  // INFO from f.f
+  // END of GAMGAMLL subroutine in the FORTRAN version
   ////////////////////////////////////////////////////////////////
 
-  const double gamma = cm.energy() / sqs_, betgam = cm.pz() / sqs_;
+  //--- kinematics computation for both leptons, boosted to the laboratory frame
 
-  if ( cuts_.cuts_mode == Kinematics::NoCuts ) {
-    DebuggingInsideLoop( Form( "No cuts applied on the outgoing leptons kinematics!" ) );
-  }
-  //--- kinematics computation for both leptons
+  const Particle::Momentum cm = event_->getOneByRole( Particle::IncomingBeam1 ).momentum() + event_->getOneByRole( Particle::IncomingBeam2 ).momentum();
+  const double gamma = cm.energy() / sqs_, betgam = cm.pz() / sqs_;
 
-  p6_cm_.betaGammaBoost( gamma, betgam );
-  p7_cm_.betaGammaBoost( gamma, betgam );
+  const V e6 = gamma*el6+betgam*p6z, pz6 = gamma*p6z+betgam*el6,
+          e7 = gamma*el7+betgam*p7z, pz7 = gamma*p7z+betgam*el7;
+  const V pt6 = Simd::sqrt( p6x*p6x+p6y*p6y ),
+          pt7 = Simd::sqrt( p7x*p7x+p7y*p7y );
 
   //--- cut on mass of final hadronic system (MX/Y)
 
-  if ( cuts_.mode == Kinematics::InelasticElastic || cuts_.mode == Kinematics::InelasticInelastic ) {
-    if ( MX_<cuts_.mx_min || MX_>cuts_.mx_max ) return 0.;
-  }
-  if ( cuts_.mode == Kinematics::ElasticInelastic || cuts_.mode == Kinematics::InelasticInelastic ) {
-    if ( MY_<cuts_.mx_min || MY_>cuts_.mx_max ) return 0.;
-  }
+  Simd::Mask<V> pass = ok;
+  if ( inel_p1 ) pass = pass && !( mx < cuts_.mx_min ) && !( mx > cuts_.mx_max );
+  if ( inel_p2 ) pass = pass && !( my < cuts_.mx_min ) && !( my > cuts_.mx_max );
 
   //--- cut on the proton's Q2 (first photon propagator T1)
 
-  if ( ( cuts_.q2_max!=-1. && t1_<-cuts_.q2_max ) || t1_>-cuts_.q2_min ) { return 0.;  }
+  pass = pass && !( t1 > -cuts_.q2_min );
+  if ( cuts_.q2_max != -1. ) pass = pass && !( t1 < -cuts_.q2_max );
 
   //--- cuts on outgoing leptons' kinematics
 
-  bool lcut = false; // event discarded by default
-
-  const double cott6 = p6_cm_.pz()/p6_cm_.pt(),
-               cott7 = p7_cm_.pz()/p7_cm_.pt();
-
-  if ( cuts_.mass_min > 0. && ( p6_cm_+p7_cm_ ).mass() < cuts_.mass_min ) return 0.;
-  if ( cuts_.mass_max > 0. && ( p6_cm_+p7_cm_ ).mass() > cuts_.mass_max ) return 0.;
+  if ( cuts_.mass_min > 0. || cuts_.mass_max > 0. ) {
+    const V sx = p6x+p7x, sy = p6y+p7y, sz = pz6+pz7, se = e6+e7;
+    const V m2 = se*se-( sx*sx+sy*sy+sz*sz );
+    const V mass = Simd::select( m2 >= 0., Simd::sqrt( m2 ), -Simd::sqrt( -m2 ) );
+    if ( cuts_.mass_min > 0. ) pass = pass && !( mass < cuts_.mass_min );
+    if ( cuts_.mass_max > 0. ) pass = pass && !( mass > cuts_.mass_max );
+  }
 
-  bool lmu1 = cott6 >= cot_theta1_
-           && cott6 <= cot_theta2_
-           && ( p6_cm_.pt() >= cuts_.pt_min || cuts_.pt_min <= 0. )
-           && ( p6_cm_.pt() <= cuts_.pt_max || cuts_.pt_max <= 0. )
-           && ( p6_cm_.energy() >= cuts_.e_min || cuts_.e_min <= 0. )
-           && ( p6_cm_.energy() <= cuts_.e_max || cuts_.e_max <= 0. );
-  bool lmu2 = cott7>=cot_theta1_
-           && cott7<=cot_theta2_
-           && ( p7_cm_.pt() >= cuts_.pt_min || cuts_.pt_min <= 0. )
-           && ( p7_cm_.pt() <= cuts_.pt_max || cuts_.pt_max <= 0. )
-           && ( p7_cm_.energy() >= cuts_.e_min || cuts_.e_min <= 0. )
-           && ( p7_cm_.energy() <= cuts_.e_max || cuts_.e_max <= 0. );
+  const V cott6 = pz6/pt6,
+          cott7 = pz7/pt7;
+  Simd::Mask<V> lmu1 = ( cott6 >= cot_theta1_ ) && ( cott6 <= cot_theta2_ ),
+                lmu2 = ( cott7 >= cot_theta1_ ) && ( cott7 <= cot_theta2_ );
+  if ( cuts_.pt_min > 0. ) { lmu1 = lmu1 && ( pt6 >= cuts_.pt_min ); lmu2 = lmu2 && ( pt7 >= cuts_.pt_min ); }
+  if ( cuts_.pt_max > 0. ) { lmu1 = lmu1 && ( pt6 <= cuts_.pt_max ); lmu2 = lmu2 && ( pt7 <= cuts_.pt_max ); }
+  if ( cuts_.e_min > 0. )  { lmu1 = lmu1 && ( e6 >= cuts_.e_min );   lmu2 = lmu2 && ( e7 >= cuts_.e_min ); }
+  if ( cuts_.e_max > 0. )  { lmu1 = lmu1 && ( e6 <= cuts_.e_max );   lmu2 = lmu2 && ( e7 <= cuts_.e_max ); }
 
   switch ( cuts_.cuts_mode ) {
-    case Kinematics::BothParticles: { lcut = lmu1 && lmu2; } break;
-    case Kinematics::OneParticle:   { lcut = lmu1 || lmu2; } break;
-    case Kinematics::NoCuts: default: lcut = true; break;
+    case Kinematics::BothParticles: pass = pass && lmu1 && lmu2; break;
+    case Kinematics::OneParticle:   pass = pass && ( lmu1 || lmu2 ); break;
+    case Kinematics::NoCuts: default: break;
+  }
+  // dismiss the cuts-failing events in the cross-section computation
+  if ( !Simd::any( pass ) ) return zero;
+
+  //--- matrix element convoluted with the form factors (periPP in LPAIR)
+
+  const V q1 = -t1, q2 = -t2;
+  V fe1 = zero, fm1 = zero, fe2 = zero, fm2 = zero;
+  if ( mode == Kinematics::ElasticElastic ) {
+    // elastic form factors (see ElasticFormFactors)
+    const V ge1 = 1./( ( 1.+q1/0.71 )*( 1.+q1/0.71 ) ), gm1 = 2.79*ge1,
+            ge2 = 1./( ( 1.+q2/0.71 )*( 1.+q2/0.71 ) ), gm2 = 2.79*ge2;
+    fe1 = ( 4.*w1_*ge1*ge1+q1*gm1*gm1 )/( 4.*w1_+q1 ); fm1 = gm1*gm1;
+    fe2 = ( 4.*w2_*ge2*ge2+q2*gm2*gm2 )/( 4.*w2_+q2 ); fm2 = gm2*gm2;
+  }
+  else {
+    for ( unsigned short l=0; l<Simd::width<V>(); l++ ) {
+      FormFactors fp1, fp2;
+      GenericProcess::formFactors<mode,sf>( Simd::get( q1, l ), Simd::get( q2, l ), Simd::get( mx2, l ), Simd::get( my2, l ), fp1, fp2 );
+      Simd::set( fe1, l, fp1.FE ); Simd::set( fm1, l, fp1.FM );
+      Simd::set( fe2, l, fp2.FE ); Simd::set( fm2, l, fp2.FM );
+    }
   }
-  if ( !lcut ) return 0.; // dismiss the cuts-failing events in the cross-section computation
-
-  switch ( cuts_.mode ) { // inherited from CDF version
-    case Kinematics::ElectronProton: default: jacobian_ *= periPP( 1, 2 ); break; // ep case
-    case Kinematics::ElasticElastic:          jacobian_ *= periPP( 2, 2 ); break; // elastic case
-    case Kinematics::InelasticElastic:        jacobian_ *= periPP( 3, 2 )*( dw31_*dw31_ ); break;
-    case Kinematics::ElasticInelastic:        jacobian_ *= periPP( 3, 2 )*( dw52_*dw52_ ); break; // single-dissociative case
-    case Kinematics::InelasticInelastic:      jacobian_ *= periPP( 3, 3 )*( dw31_*dw31_ )*( dw52_*dw52_ ); break; // double-dissociative case
+
+  const V qqq = q1dq*q1dq,
+          qdq = 4.*Ml12_-w4;
+  const V eps_delta = epsi-delta*( qdq+q1dq2 );
+  const V t11 = 64. *(  bb*( qqq-g4-qdq*( t1+t2+2.*Ml12_ ) )-2.*( t1+2.*Ml12_ )*( t2+2.*Ml12_ )*qqq ) * t1*t2,
+          t12 = 128.*( -bb*( dd2+g6 )-2.*( t1+2.*Ml12_ )*( sa2*qqq+a6*a6 ) ) * t1,
+          t21 = 128.*( -bb*( dd4+g5 )-2.*( t2+2.*Ml12_ )*( sa1*qqq+a5*a5 ) ) * t2,
+          t22 = 512.*(  bb*( delta*delta-gram )-eps_delta*eps_delta-sa1*a6*a6-sa2*a5*a5-sa1*sa2*qqq );
+
+  const V den = 2.*t1*t2*bb;
+  V peripp = ( fm1*fm2*t11
+              +fe1*fm2*t21
+              +fm1*fe2*t12
+              +fe1*fe2*t22 ) / ( den*den );
+  // inherited from CDF version
+  if ( inel_p1 ) peripp *= dmx*dmx;
+  if ( inel_p2 ) peripp *= dmy*dmy;
+
+  if ( out ) {
+    const V p3[] = { p3x, p3y, p3z, ep3 }, p5[] = { p5x, p5y, p5z, ep5 },
+            p6[] = { p6x, p6y, pz6, e6 }, p7[] = { p7x, p7y, pz7, e7 };
+    std::copy( p3, p3+4, out->p3 ); std::copy( p5, p5+4, out->p5 );
+    std::copy( p6, p6+4, out->p6 ); std::copy( p7, p7+4, out->p7 );
+    out->t1 = t1; out->t2 = t2;
   }
 
   //--- compute the event weight using the Jacobian
 
-  return Constants::GeV2toBarn*jacobian_;
+  return Simd::select( pass, Constants::GeV2toBarn*weight*peripp, zero );
+}
+
+template<CepGen::Kinematics::ProcessMode mode, CepGen::StructureFunctions sf> double
+GamGamLL::computeWeight()
+{
+  if ( !is_outgoing_state_set_ ) { InWarning( "Output state not set!" ); return 0.; }
+
+  DebuggingInsideLoop( Form( "sqrt(s)=%f\n\tm(X1)=%f\tm(X2)=%f", sqs_, MX_, MY_ ) );
+
+  Outgoing<double> out = Outgoing<double>();
+  const double weight = computeLanes<mode,sf>( &x_[0], MX_, MY_, dw31_, dw52_, n_opt_, &out );
+  DebuggingInsideLoop( Form( "Weight = %e", weight ) );
+  if ( weight == 0. ) return 0.;
+
+  //--- outgoing particles' kinematics, for the event to be filled (see fillKinematics)
+  p3_lab_ = Particle::Momentum( out.p3[0], out.p3[1], out.p3[2], out.p3[3] );
+  p5_lab_ = Particle::Momentum( out.p5[0], out.p5[1], out.p5[2], out.p5[3] );
+  p6_cm_ = Particle::Momentum( out.p6[0], out.p6[1], out.p6[2], out.p6[3] );
+  p7_cm_ = Particle::Momentum( out.p7[0], out.p7[1], out.p7[2], out.p7[3] );
+  t1_ = out.t1;
+  t2_ = out.t2;
+
+  return weight;
+}
+
+void
+GamGamLL::computeWeights( const double* x, unsigned int ndim, size_t num_points, double* weights )
+{
+  if ( num_points == 0 ) return;
+  if ( !is_outgoing_state_set_ ) {
+    InWarning( "Output state not set!" );
+    std::fill( weights, weights+num_points, 0. );
+    return;
+  }
+  x_.resize( ndim );
+  is_point_set_ = true;
+  ( this->*compute_weights_ )( x, num_points, weights );
+}
+
+template<CepGen::Kinematics::ProcessMode mode, CepGen::StructureFunctions sf> void
+GamGamLL::computeBlockWeights( const double* x, size_t num_points, double* weights )
+{
+  typedef Simd::Vector Vector;
+  const unsigned short width = Simd::width<Vector>();
+
+  //--- outgoing proton-like particles' masses (only fixed for the run in the elastic case, see beforeComputeWeight)
+  beforeComputeWeight();
+  Vector mx = Simd::broadcast<Vector>( MX_ ), my = Simd::broadcast<Vector>( MY_ ),
+         dmx = Simd::broadcast<Vector>( dw31_ ), dmy = Simd::broadcast<Vector>( dw52_ );
+
+  size_t j = 0;
+  for ( ; j+width <= num_points; j+=width ) {
+    Vector xv[7];
+    for ( unsigned short i=0; i<7; i++ ) xv[i] = Simd::load<Vector>( x+i*num_points+j );
+    if ( mode != Kinematics::ElasticElastic ) {
+      for ( unsigned short l=0; l<width; l++ ) {
+        for ( unsigned int i=7; i<x_.size(); i++ ) x_[i] = x[i*num_points+j+l];
+        beforeComputeWeight();
+        Simd::set( mx, l, MX_ ); Simd::set( my, l, MY_ );
+        Simd::set( dmx, l, dw31_ ); Simd::set( dmy, l, dw52_ );
+      }
+    }
+    Simd::store( weights+j, computeLanes<mode,sf,Vector>( xv, mx, my, dmx, dmy, n_opt_, nullptr ) );
+  }
+  //--- remaining points
+  for ( ; j<num_points; j++ ) {
+    for ( unsigned int i=0; i<x_.size(); i++ ) x_[i] = x[i*num_points+j];
+    beforeComputeWeight();
+    weights[j] = computeWeight<mode,sf>();
+  }
 }
 
+
 void
 GamGamLL::fillKinematics( bool )
 {
@@ -778,9 +788,9 @@ GamGamLL::fillKinematics( bool )
   p5_lab_.betaGammaBoost( gamma, betgam );
 
   // Needed to parametrise a random rotation around z-axis
-  const int rany = ((double)rand()>=.5*RAND_MAX) ? 1 : -1,
-            ransign = ((double)rand()>=.5*RAND_MAX) ? 1 : -1;
-  const double ranphi = ((double)rand()/RAND_MAX)*2.*M_PI;
+  const int rany = ( rng_.uniform() >= .5 ) ? 1 : -1,
+            ransign = ( rng_.uniform() >= .5 ) ? 1 : -1;
+  const double ranphi = rng_.uniform()*2.*M_PI;
 
   Particle::Momentum plab_ph1 = ( plab_ip1-p3_lab_ ).rotatePhi( ranphi, rany );
   Particle::Momentum plab_ph2 = ( plab_ip2-p5_lab_ ).rotatePhi( ranphi, rany );
@@ -790,7 +800,7 @@ GamGamLL::fillKinematics( bool )
   p6_cm_.rotatePhi( ranphi, rany );
   p7_cm_.rotatePhi( ranphi, rany );
 
-  /*if ( symmetrise_ && (double)rand()>=.5*RAND_MAX ) {
+  /*if ( symmetrise_ && rng_.uniform() >= .5 ) {
     p6_cm_.mirrorZ();
     p7_cm_.mirrorZ();
   }*/
@@ -877,31 +887,3 @@ GamGamLL::fillKinematics( bool )
   ol2.setStatus( Particle::FinalState );
 }
 
-double
-GamGamLL::periPP( int nup_, int ndown_ )
-{
-  DebuggingInsideLoop( Form( " Nup  = %d\n\tNdown = %d", nup_, ndown_ ) );
-
-  FormFactors fp1, fp2;
-  GenericProcess::formFactors( -t1_, -t2_, fp1, fp2 );
-
-  DebuggingInsideLoop( Form( "u1 = %f\n\tu2 = %f\n\tv1 = %f\n\tv2 = %f", fp1.FM, fp1.FE, fp2.FM, fp2.FE ) );
-
-  const double qqq = q1dq_*q1dq_,
-               qdq = 4.*Ml12_-w4_;
-  const double t11 = 64. *(  bb_*( qqq-g4_-qdq*( t1_+t2_+2.*Ml12_ ) )-2.*( t1_+2.*Ml12_ )*( t2_+2.*Ml12_ )*qqq ) * t1_*t2_,
-               t12 = 128.*( -bb_*( dd2_+g6_ )-2.*( t1_+2.*Ml12_ )*( sa2_*qqq+a6_*a6_ ) ) * t1_,
-               t21 = 128.*( -bb_*( dd4_+g5_ )-2.*( t2_+2.*Ml12_ )*( sa1_*qqq+a5_*a5_ ) ) * t2_,
-               t22 = 512.*(  bb_*( delta_*delta_-gram_ )-std::pow(epsi_-delta_*(qdq+q1dq2_), 2)-sa1_*a6_*a6_-sa2_*a5_*a5_-sa1_*sa2_*qqq );
-
-  const double peripp = ( fp1.FM*fp2.FM*t11
-                         +fp1.FE*fp2.FM*t21
-                         +fp1.FM*fp2.FE*t12
-                         +fp1.FE*fp2.FE*t22 ) / pow( 2.*t1_*t2_*bb_, 2 );
-
-  DebuggingInsideLoop( Form( "t11 = %5.2f\tt12 = %5.2f\n\t"
-                             "t21 = %5.2f\tt22 = %5.2f\n\t"
-                             "=> PeriPP = %e", t11, t12, t21, t22, peripp ) );
-
-  return peripp;
-}
@@ -1,4 +1,5 @@
 #include "GenericProcess.h"
+#include "CepGen/Core/Profiler.h"
 
 namespace CepGen
 {
@@ -11,19 +12,41 @@ namespace CepGen
       total_gen_time_( 0. ), num_gen_events_( 0 ), has_event_( has_event )
     {}
 
+    GenericProcess::GenericProcess( const GenericProcess& proc ) :
+      x_( proc.x_ ), incoming_state_( proc.incoming_state_ ), outgoing_state_( proc.outgoing_state_ ),
+      s_( proc.s_ ), sqs_( proc.sqs_ ), w1_( proc.w1_ ), w2_( proc.w2_ ), t1_( proc.t1_ ), t2_( proc.t2_ ), MX_( proc.MX_ ), MY_( proc.MY_ ),
+      cuts_( proc.cuts_ ), rng_( proc.rng_ ),
+      event_( std::shared_ptr<Event>( new Event( *proc.event_ ) ) ),
+      is_point_set_( proc.is_point_set_ ), is_incoming_state_set_( proc.is_incoming_state_set_ ),
+      is_outgoing_state_set_( proc.is_outgoing_state_set_ ), is_kinematics_set_( proc.is_kinematics_set_ ),
+      name_( proc.name_ ), description_( proc.description_ ),
+      total_gen_time_( proc.total_gen_time_ ), num_gen_events_( proc.num_gen_events_ ), has_event_( proc.has_event_ )
+    {}
+
     GenericProcess::~GenericProcess()
     {}
 
     void
     GenericProcess::setPoint( const unsigned int ndim, double* x )
     {
-      if ( ndim != x_.size() ) x_.resize( ndim );
-
-      x_ = std::vector<double>( x, x+ndim );
+      //--- copy in place, so that no memory is (re)allocated for each point
+      x_.assign( x, x+ndim );
       is_point_set_ = true;
       if ( Logger::get().level>=Logger::DebugInsideLoop ) { dumpPoint( DebugMessage ); }
     }
 
+    void
+    GenericProcess::computeWeights( const double* x, unsigned int ndim, size_t num_points, double* weights )
+    {
+      x_.resize( ndim );
+      for ( size_t j=0; j<num_points; j++ ) {
+        for ( unsigned int i=0; i<ndim; i++ ) x_[i] = x[i*num_points+j];
+        is_point_set_ = true;
+        beforeComputeWeight();
+        weights[j] = computeWeight();
+      }
+    }
+
     void
     GenericProcess::prepareKinematics()
     {
@@ -109,6 +132,7 @@ namespace CepGen
     void
     GenericProcess::formFactors( double q1, double q2, FormFactors& fp1, FormFactors& fp2 ) const
     {
+      ProfileRegion( "form factors" );
       const double mx2 = MX_*MX_, my2 = MY_*MY_;
 
       bool inel_p1 = false,
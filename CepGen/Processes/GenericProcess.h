@@ -6,6 +6,8 @@
 #include "CepGen/Physics/Physics.h"
 #include "CepGen/Physics/StructureFunctions.h"
 #include "CepGen/Physics/FormFactors.h"
+#include "CepGen/Core/RandomGenerator.h"
+#include "CepGen/Core/Profiler.h"
 
 #include <vector>
 
@@ -41,14 +43,18 @@ namespace CepGen
         /// \param[in] description Human-readable description of the process
         /// \param[in] has_event Do we generate the associated event structure?
         GenericProcess( const std::string& name, const std::string& description="<invalid process>", bool has_event=true );
+        /// Copy constructor (the event record is duplicated, not shared)
+        GenericProcess( const GenericProcess& );
         virtual ~GenericProcess();
+        /// Independent copy of this process, in its current state, e.g. to compute weights in a concurrent thread
+        virtual GenericProcess* clone() const = 0;
 
         /// Restore the Event object to its initial state
         inline void clearEvent() { event_->restore(); }
         /// Set the kinematics of the incoming state particles
         void setIncomingKinematics( const Particle::Momentum& p1, const Particle::Momentum& p2 );
-        /// Compute the incoming state kinematics
-        void prepareKinematics();
+        /// Compute the incoming state kinematics (and the quantities fixed for the whole run, if the process caches any)
+        virtual void prepareKinematics();
 
       public:
         /// Set the incoming and outgoing state to be expected in the process
@@ -57,6 +63,13 @@ namespace CepGen
         inline virtual void beforeComputeWeight() { Debugging( "Virtual method called" ); }
         /// Compute the weight for this point in the phase-space
         virtual double computeWeight() = 0;
+        /// Compute the weights for a batch of points in the phase-space
+        /// \param[in] x Coordinates of the points, in the structure-of-arrays form (x[i*num_points+j] is the i-th coordinate of the j-th point)
+        /// \param[in] ndim Number of dimensions of each point
+        /// \param[in] num_points Number of points in the batch
+        /// \param[out] weights Weight of each point
+        /// \note The event kinematics is left undefined. By default, the points are computed one after the other
+        virtual void computeWeights( const double* x, unsigned int ndim, size_t num_points, double* weights );
         /// Fill the Event object with the particles' kinematics
         /// \param[in] symmetrise Symmetrise the event? (randomise the production of positively- and negatively-charged outgoing central particles)
         virtual void fillKinematics( bool symmetrise=false ) = 0;
@@ -66,6 +79,10 @@ namespace CepGen
         /// Set the list of kinematic cuts to apply on the outgoing particles' final state
         /// \param[in] cuts The Cuts object containing the kinematic parameters
         inline virtual void setKinematics( const Kinematics& cuts ) { cuts_ = cuts; }
+        /// Set the random numbers generator to be used for the event kinematics (e.g. azimuthal rotations)
+        inline void setRandomGenerator( const RandomGenerator& rng ) { rng_ = rng; }
+        /// Random numbers generator used for the event kinematics
+        inline RandomGenerator& randomGenerator() { return rng_; }
 
       public:
         /**
@@ -91,6 +108,8 @@ namespace CepGen
         inline const std::string& name() const { return name_; }
         /// Human-readable description of the process
         inline const std::string& description() const { return description_; }
+        /// Process-specific settings changing the integrand definition (empty if none)
+        inline virtual std::string settings() const { return ""; }
 
         bool hasEvent() const { return has_event_; }
 
@@ -115,6 +134,11 @@ namespace CepGen
         void setEventContent( const IncomingState& is, const OutgoingState& os );
         /// Compute the electric/magnetic form factors for the two considered \f$Q^{2}\f$ momenta transfers
         void formFactors( double q1, double q2, FormFactors& fp1, FormFactors& fp2 ) const;
+        /// Compute the electric/magnetic form factors for a process mode and a beam remnant modelling known at compile time,
+        /// and the outgoing proton-like particles' squared masses \a mx2 and \a my2
+        /// \note The structure functions are one of SuriYennie, Fiore, or SzczurekUleshchenko (see InelasticFormFactors)
+        template<Kinematics::ProcessMode mode, StructureFunctions sf>
+        void formFactors( double q1, double q2, double mx2, double my2, FormFactors& fp1, FormFactors& fp2 ) const;
  
         /// Get a list of references to the particles with a given role in the process
         /// \param[in] role role in the process for the particle to retrieve
@@ -148,6 +172,8 @@ namespace CepGen
 
         /// Set of cuts to apply on the final phase space
         Kinematics cuts_;
+        /// Random numbers generator for the degrees of freedom not sampled by the integrator
+        RandomGenerator rng_;
         /// Event object containing all the information on the in- and outgoing particles
         std::shared_ptr<Event> event_;
         /// Is the phase space point set?
@@ -178,6 +204,22 @@ namespace CepGen
          */
         bool isKinematicsDefined();
     };
+
+    template<Kinematics::ProcessMode mode, StructureFunctions sf> inline void
+    GenericProcess::formFactors( double q1, double q2, double mx2, double my2, FormFactors& fp1, FormFactors& fp2 ) const
+    {
+      ProfileRegion( "form factors" );
+      const bool trivial_p1 = ( mode == Kinematics::ElectronProton || mode == Kinematics::ElectronElectron ),
+                 trivial_p2 = ( mode == Kinematics::ProtonElectron || mode == Kinematics::ElectronElectron ),
+                 inel_p1 = ( mode == Kinematics::InelasticElastic || mode == Kinematics::InelasticInelastic ),
+                 inel_p2 = ( mode == Kinematics::ElasticInelastic || mode == Kinematics::InelasticInelastic );
+      fp1 = trivial_p1 ? TrivialFormFactors()
+          : inel_p1 ? InelasticFormFactors<sf>( q1, w1_, mx2 )
+          : ElasticFormFactors( q1, w1_ );
+      fp2 = trivial_p2 ? TrivialFormFactors()
+          : inel_p2 ? InelasticFormFactors<sf>( q2, w2_, my2 )
+          : ElasticFormFactors( q2, w2_ );
+    }
   }
 }
 
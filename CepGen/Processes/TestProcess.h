@@ -13,6 +13,7 @@ namespace CepGen
       public:
         TestProcess();
         ~TestProcess() {}
+        GenericProcess* clone() const { return new TestProcess( *this ); }
 
         void addEventContent() {}
         /// Number of dimensions on which to perform the integration
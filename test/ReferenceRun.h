@@ -0,0 +1,47 @@
+#ifndef Test_ReferenceRun_h
+#define Test_ReferenceRun_h
+
+#include "CepGen/Generator.h"
+#include "CepGen/Parameters.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+#include <vector>
+
+namespace CepGen
+{
+  /**
+   * Set the run shared by the tests: elastic two-photon production of muon pairs at \f$\sqrt s\f$ = 13 TeV,
+   * with both muons within \f$p_T>\f$ 15 GeV and \f$|\eta|<\f$ 2.5, integrated from 2 iterations of
+   * 5\f$\times\f$10\f$^4\f$ calls with a fixed seed
+   * \param[out] params Run parameters to set
+   * \param[in] proc Process to run (owned by the parameters), or the default LPAIR one if null
+   */
+  inline void
+  setReferenceRun( Parameters& params, Process::GenericProcess* proc=nullptr )
+  {
+    params.setProcess( proc ? proc : new Process::GamGamLL );
+    params.kinematics.mode = Kinematics::ElasticElastic;
+    params.kinematics.setSqrtS( 13.e3 );
+    params.kinematics.pair = Particle::Muon;
+    params.kinematics.cuts_mode = Kinematics::BothParticles;
+    params.kinematics.pt_min = 15.;
+    params.kinematics.eta_min = -2.5;
+    params.kinematics.eta_max = 2.5;
+    params.vegas.ncvg = 5e4;
+    params.vegas.itvg = 2;
+    params.vegas.seed = 42;
+  }
+
+  /// Transverse momentum of the first outgoing lepton in each of a number of events generated in a row
+  inline std::vector<double>
+  generateLeptonPt( Generator& mg, unsigned int num_events )
+  {
+    std::vector<double> pt;
+    for ( unsigned int i=0; i<num_events; i++ ) {
+      pt.emplace_back( mg.generateOneEvent()->getConstById( 6 ).momentum().pt() );
+    }
+    return pt;
+  }
+}
+
+#endif
@@ -0,0 +1,338 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstdio>
+#include <cerrno>
+#include <ctime>
+#include <memory>
+
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+
+#include "CepGen/Generator.h"
+#include "CepGen/Core/utils.h"
+#include "CepGen/Cards/LpairReader.h"
+#include "CepGen/Cards/ConfigReader.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+using namespace std;
+
+/// Bookkeeping of one worker of the farm
+struct Worker
+{
+  Worker() : pid( -1 ), seed( 0 ), stream( 0 ), num_events( 0 ), num_restarts( 0 ), done( false ), stalled( false ),
+             launch_time( 0 ), cross_section( 0. ), cross_section_error( 0. ), time( 0. ) {}
+  pid_t pid;
+  /// Seed (common to all workers) and first random numbers stream of this worker
+  unsigned long long seed, stream;
+  unsigned long num_events;
+  unsigned short num_restarts;
+  bool done;
+  /// Was the current process of this worker killed for a lack of activity?
+  bool stalled;
+  /// Output files of this worker
+  string events_file, checkpoint_file, result_file, log_file;
+  /// Start of the current process of this worker
+  time_t launch_time;
+  Timer attempt_timer;
+  /// Results read back from the worker
+  double cross_section, cross_section_error;
+  /// Wall time summed over all processes of this worker (restarts included), in s
+  double time;
+};
+
+void
+setParameters( CepGen::Generator& mg, const string& card )
+{
+  if ( card == "default" ) {
+    mg.parameters->setProcess( new CepGen::Process::GamGamLL );
+    mg.parameters->kinematics.mode = CepGen::Kinematics::ElasticElastic;
+    mg.parameters->remnant_mode = CepGen::SuriYennie;
+    mg.parameters->kinematics.in1p = mg.parameters->kinematics.in2p = 6500.;
+    mg.parameters->kinematics.pair = CepGen::Particle::Muon;
+    mg.parameters->kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+    mg.parameters->kinematics.pt_min = 15.;
+    mg.parameters->kinematics.eta_min = -2.5;
+    mg.parameters->kinematics.eta_max = 2.5;
+    mg.parameters->vegas.ncvg = 5e4;
+    return;
+  }
+  const string extension = card.substr( card.find_last_of( "." )+1 );
+  if ( extension == "card" ) mg.setParameters( CepGen::Cards::LpairReader( card.c_str() ).parameters() );
+  else if ( extension == "cfg" ) mg.setParameters( CepGen::Cards::ConfigReader( card.c_str() ).parameters() );
+  else throw CepGen::Exception( __PRETTY_FUNCTION__, Form( "Unrecognised card \"%s\"", card.c_str() ), CepGen::FatalError );
+}
+
+/// Write one event as a block of plain text lines
+void
+writeEvent( ostream& os, unsigned long num, const CepGen::Event& ev )
+{
+  os << "event " << num << " " << ev.numParticles() << "\n";
+  for ( unsigned int i=0; i<ev.numParticles(); i++ ) {
+    const CepGen::Particle& part = ev.getConstById( i );
+    const CepGen::ParticlesIds mothers = part.mothersIds();
+    os << Form( "%d %d %d %d %d %.10e %.10e %.10e %.10e %.10e\n",
+                part.id(), part.integerPdgId(), part.role(), part.status(), mothers.empty() ? -1 : *mothers.begin(),
+                part.momentum().px(), part.momentum().py(), part.momentum().pz(), part.energy(), part.mass() );
+  }
+}
+
+/**
+ * Body of one worker: generate its quota of events with its own seed, resuming
+ * from its last checkpoint if it was restarted, and store its results.
+ * \return The exit code of the worker
+ */
+int
+runWorker( const string& card, const Worker& wrk )
+{
+  if ( !freopen( wrk.log_file.c_str(), "a", stdout ) ) return 1;
+  setvbuf( stdout, nullptr, _IOLBF, BUFSIZ ); // the log file is the heartbeat of the worker
+  CepGen::Generator mg;
+  setParameters( mg, card );
+  mg.parameters->vegas.seed = wrk.seed;
+  mg.parameters->vegas.stream = wrk.stream;
+  mg.parameters->generation.enabled = true;
+  mg.parameters->generation.checkpoint_every = max( 1ul, wrk.num_events/20 );
+  mg.parameters->generation.checkpoint_file = wrk.checkpoint_file;
+
+  unsigned long num_generated = 0;
+  fstream out;
+  if ( access( wrk.checkpoint_file.c_str(), R_OK ) == 0 ) {
+    //--- restarted worker: continue from the last complete checkpoint
+    const CepGen::Checkpoint ckpt = mg.resume( wrk.checkpoint_file );
+    num_generated = ckpt.ngen;
+    if ( truncate( wrk.events_file.c_str(), ckpt.output_position ) != 0 ) return 1;
+    out.open( wrk.events_file, fstream::out | fstream::app );
+    Information( Form( "Worker resumed after %lu events", num_generated ) );
+  }
+  else out.open( wrk.events_file, fstream::out | fstream::trunc );
+  if ( !out.is_open() ) return 1;
+
+  CepGen::EventStream events = mg.events( wrk.num_events-num_generated );
+  events.onCheckpoint( [&out]() -> long long { out.flush(); return out.tellp(); } );
+  for ( const CepGen::Event& ev : events ) writeEvent( out, num_generated++, ev );
+  out.close();
+  if ( out.fail() ) return 1;
+
+  const bool stored = writeAtomically( wrk.result_file, [&]( ostream& os ) {
+    os << Form( "%.10e %.10e %lu\n", mg.crossSection(), mg.crossSectionError(), num_generated );
+  } );
+  return stored ? 0 : 1;
+}
+
+/// Fork a worker process
+void
+launch( const string& card, Worker& wrk )
+{
+  cout.flush();
+  const pid_t pid = fork();
+  if ( pid < 0 ) throw CepGen::Exception( __PRETTY_FUNCTION__, "Failed to fork a worker", CepGen::FatalError );
+  if ( pid == 0 ) _exit( runWorker( card, wrk ) );
+  wrk.pid = pid;
+  wrk.stalled = false;
+  wrk.launch_time = time( nullptr );
+  wrk.attempt_timer.reset();
+}
+
+/// Time of the last output of a worker (log, events, or checkpoint), or of its launch
+time_t
+lastActivity( const Worker& wrk )
+{
+  time_t last = wrk.launch_time;
+  for ( const string& file : { wrk.log_file, wrk.events_file, wrk.checkpoint_file } ) {
+    struct stat st;
+    if ( stat( file.c_str(), &st ) == 0 ) last = max( last, st.st_mtime );
+  }
+  return last;
+}
+
+/// Read the events blocks of one worker
+class EventsReader
+{
+  public:
+    explicit EventsReader( const string& file ) : in_( file ) {}
+    /// Copy the next event into a stream, renumbered
+    bool next( ostream& os, unsigned long num ) {
+      string key, line;
+      unsigned long ev_num;
+      unsigned int num_parts;
+      if ( !( in_ >> key >> ev_num >> num_parts ) || key != "event" ) return false;
+      getline( in_, line );
+      os << "event " << num << " " << num_parts << "\n";
+      for ( unsigned int i=0; i<num_parts; i++ ) {
+        if ( !getline( in_, line ) ) return false;
+        os << line << "\n";
+      }
+      return true;
+    }
+  private:
+    ifstream in_;
+};
+
+/**
+ * Local farm of generation jobs: a number of worker processes are forked from
+ * a single card, each one with its own random numbers streams (on top of the
+ * seed of the card) and events quota. The failed workers, and the ones without
+ * any output for a given time, are restarted (from their last checkpoint), and all outputs are
+ * merged once the farm completed: cross sections combined with inverse-variance
+ * weights, events files concatenated or interleaved, and a run summary.
+ * \date Oct 2026
+ */
+int main( int argc, char* argv[] ) {
+  if ( argc < 4 ) {
+    InError( Form( "Usage: %s <config card|default> <num workers> <num events> [output dir=farm] [merging=concat|interleave] [max restarts=3] [stall timeout (s), 0 to disable=600]", argv[0] ) );
+    return -1;
+  }
+  const string card = argv[1];
+  const unsigned int num_workers = max( 1, atoi( argv[2] ) );
+  const unsigned long num_events = strtoul( argv[3], nullptr, 10 );
+  const string dir = ( argc > 4 ) ? argv[4] : "farm";
+  const string merging = ( argc > 5 ) ? argv[5] : "concat";
+  const unsigned short max_restarts = ( argc > 6 ) ? atoi( argv[6] ) : 3;
+  const unsigned int stall_timeout = ( argc > 7 ) ? atoi( argv[7] ) : 600;
+  if ( merging != "concat" && merging != "interleave" ) {
+    InError( Form( "Invalid merging mode \"%s\"", merging.c_str() ) );
+    return -1;
+  }
+  if ( mkdir( dir.c_str(), 0755 ) != 0 && errno != EEXIST ) {
+    InError( Form( "Failed to create the output directory \"%s\"", dir.c_str() ) );
+    return -1;
+  }
+
+  unsigned long long seed, base_stream;
+  {
+    //--- only parse the card here, no thread is to be started before the workers are forked
+    CepGen::Generator mg;
+    setParameters( mg, card );
+    seed = mg.parameters->vegas.seed;
+    base_stream = mg.parameters->vegas.stream;
+    mg.parameters->dump();
+  }
+
+  Timer tmr;
+  vector<Worker> workers( num_workers );
+  map<pid_t,unsigned int> running;
+  for ( unsigned int i=0; i<num_workers; i++ ) {
+    Worker& wrk = workers[i];
+    //--- one block of 2^32 streams per worker, far more than the few ones used by a run
+    wrk.seed = seed;
+    wrk.stream = base_stream+( ( i+1ull ) << 32 );
+    wrk.num_events = num_events/num_workers + ( i < num_events%num_workers ? 1 : 0 );
+    const string prefix = Form( "%s/worker_%u", dir.c_str(), i );
+    wrk.events_file = prefix+".events";
+    wrk.checkpoint_file = prefix+".checkpoint";
+    wrk.result_file = prefix+".result";
+    wrk.log_file = prefix+".log";
+    remove( wrk.checkpoint_file.c_str() );
+    remove( wrk.result_file.c_str() );
+    remove( wrk.log_file.c_str() );
+    launch( card, wrk );
+    running[wrk.pid] = i;
+    Information( Form( "Worker %u launched (pid %d) with seed %llu, stream %llu for %lu events", i, wrk.pid, wrk.seed, wrk.stream, wrk.num_events ) );
+  }
+
+  //--- monitor the workers until all of them are done or given up
+  bool failed = false;
+  while ( !running.empty() ) {
+    int status;
+    const pid_t pid = waitpid( -1, &status, WNOHANG );
+    if ( pid < 0 ) break;
+    if ( pid == 0 ) {
+      //--- no worker terminated in the meantime: kill the ones without any recent output
+      for ( const auto& run : running ) {
+        Worker& wrk = workers[run.second];
+        if ( stall_timeout == 0 || wrk.stalled || time( nullptr )-lastActivity( wrk ) < stall_timeout ) continue;
+        InWarning( Form( "Worker %u (pid %d) without any output for %u s, killing it", run.second, run.first, stall_timeout ) );
+        if ( kill( run.first, SIGKILL ) == 0 ) wrk.stalled = true;
+      }
+      usleep( 200000 );
+      continue;
+    }
+    const auto it = running.find( pid );
+    if ( it == running.end() ) continue;
+    const unsigned int i = it->second;
+    running.erase( it );
+    Worker& wrk = workers[i];
+    wrk.time += wrk.attempt_timer.elapsed();
+    ifstream res( wrk.result_file );
+    unsigned long num_generated = 0;
+    if ( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 && res >> wrk.cross_section >> wrk.cross_section_error >> num_generated ) {
+      wrk.done = true;
+      Information( Form( "Worker %u finished: %lu events in %.2f s", i, num_generated, wrk.time ) );
+      continue;
+    }
+    const string reason = wrk.stalled
+      ? Form( "stalled for %u s", stall_timeout )
+      : WIFSIGNALED( status )
+      ? Form( "killed by signal %d", WTERMSIG( status ) )
+      : Form( "exited with status %d", WEXITSTATUS( status ) );
+    if ( wrk.num_restarts >= max_restarts ) {
+      InError( Form( "Worker %u %s, giving up after %u restarts (see %s)", i, reason.c_str(), wrk.num_restarts, wrk.log_file.c_str() ) );
+      failed = true;
+      continue;
+    }
+    ++wrk.num_restarts;
+    InWarning( Form( "Worker %u %s, restarting it (%u/%u)", i, reason.c_str(), wrk.num_restarts, max_restarts ) );
+    launch( card, wrk );
+    running[wrk.pid] = i;
+  }
+  if ( failed ) {
+    InError( "Some workers failed, the outputs are not merged" );
+    return 1;
+  }
+
+  //--- combination of the cross sections
+  double sum_weights = 0., sum_xsec = 0.;
+  for ( const auto& wrk : workers ) {
+    if ( wrk.cross_section_error <= 0. ) continue;
+    const double weight = 1./wrk.cross_section_error/wrk.cross_section_error;
+    sum_weights += weight;
+    sum_xsec += weight*wrk.cross_section;
+  }
+  const double xsec = ( sum_weights > 0. ) ? sum_xsec/sum_weights : workers[0].cross_section;
+  const double err = ( sum_weights > 0. ) ? 1./sqrt( sum_weights ) : workers[0].cross_section_error;
+
+  //--- merging of the events with a consistent numbering
+  const string events_file = dir+"/events.txt";
+  ofstream out( events_file );
+  out << Form( "# cepgen-farm: %u workers, merged events (%s)\n# cross section: %.10e +- %.10e pb\n",
+               num_workers, merging.c_str(), xsec, err );
+  vector<unique_ptr<EventsReader> > readers;
+  for ( const auto& wrk : workers ) readers.emplace_back( new EventsReader( wrk.events_file ) );
+  unsigned long num_merged = 0;
+  if ( merging == "concat" ) {
+    for ( auto& rd : readers ) while ( rd->next( out, num_merged ) ) ++num_merged;
+  }
+  else {
+    vector<bool> active( readers.size(), true );
+    for ( unsigned int num_active=readers.size(); num_active>0; ) {
+      for ( unsigned int i=0; i<readers.size(); i++ ) {
+        if ( !active[i] ) continue;
+        if ( readers[i]->next( out, num_merged ) ) ++num_merged;
+        else { active[i] = false; --num_active; }
+      }
+    }
+  }
+  out.close();
+
+  //--- run summary
+  ostringstream os;
+  os << Form( "%-8s %20s %10s %25s %10s %8s\n", "worker", "stream", "events", "cross section (pb)", "time (s)", "restarts" );
+  for ( unsigned int i=0; i<num_workers; i++ ) {
+    const Worker& wrk = workers[i];
+    os << Form( "%-8u %20llu %10lu %12.5e +- %9.3e %10.2f %8u\n", i, wrk.stream, wrk.num_events, wrk.cross_section, wrk.cross_section_error, wrk.time, wrk.num_restarts );
+  }
+  os << Form( "combined cross section: %.5e +- %.3e pb\n", xsec, err )
+     << Form( "seed: %llu\n", seed )
+     << Form( "events merged: %lu / %lu in %s\n", num_merged, num_events, events_file.c_str() )
+     << Form( "wall time: %.2f s\n", tmr.elapsed() );
+  ofstream( dir+"/summary.txt" ) << os.str();
+  Information( "Farm summary:\n"+os.str() );
+
+  return ( num_merged == num_events ) ? 0 : 1;
+}
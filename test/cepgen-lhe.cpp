@@ -1,6 +1,8 @@
 #include <iostream>
+#include <unistd.h>
 
 #include "CepGen/Generator.h"
+#include "CepGen/Core/Cocktail.h"
 #include "CepGen/Cards/ConfigReader.h"
 #include "CepGen/Export/LHEFHandler.h"
 
@@ -27,21 +29,43 @@ int main( int argc, char* argv[] ) {
   // We might want to cross-check visually the validity of our run
   mg.parameters->dump();
 
-  // Let there be cross-section...
+  // Several modes to be generated together, in a single output
+  std::unique_ptr<CepGen::Cocktail> cocktail;
+  if ( !mg.parameters->cocktail.empty() ) cocktail.reset( new CepGen::Cocktail( *mg.parameters ) );
+
+  // Let there be cross-section... (unless a previous run can be resumed)
+  const char* output_file = "example.dat";
+  const std::string& checkpoint_file = mg.parameters->generation.checkpoint_file;
+  const bool resume = ( mg.parameters->generation.checkpoint_every > 0 && ifstream( checkpoint_file ).good() );
+  unsigned int num_events = mg.parameters->generation.maxgen, i = 0;
   double xsec, err;
-  mg.computeXsection( xsec, err );
+  if ( resume ) {
+    const CepGen::Checkpoint ckpt = ( cocktail ) ? cocktail->resume( checkpoint_file ) : mg.resume( checkpoint_file );
+    // drop the events written after the last checkpoint, they will be generated again
+    if ( ckpt.output_position >= 0 && truncate( output_file, ckpt.output_position ) != 0 )
+      FatalError( Form( "Failed to truncate the output file \"%s\"", output_file ) );
+    xsec = ckpt.cross_section;
+    err = ckpt.cross_section_error;
+    i = ckpt.ngen;
+    num_events = ( i < num_events ) ? num_events-i : 0;
+  }
+  else if ( cocktail ) cocktail->computeXsection( xsec, err );
+  else mg.computeXsection( xsec, err );
 
-  CepGen::OutputHandler::LHEFHandler writer( "example.dat" );
+  CepGen::OutputHandler::LHEFHandler writer( output_file, resume );
   writer.setCrossSection( xsec, err );
   writer.initialise( *mg.parameters );
 
   // The events generation starts here !
-  for ( unsigned int i = 0; i < mg.parameters->generation.maxgen; ++i ) {
+  CepGen::EventStream events = ( cocktail ) ? cocktail->events( num_events ) : mg.events( num_events );
+  events.onCheckpoint( [&writer]() { return writer.flush(); } );
+  for ( const CepGen::Event& ev : events ) {
     if ( i%1000 == 0 )
       cout << "Generating event #" << i+1 << endl;
     try {
-      writer << mg.generateOneEvent();
+      writer << &ev;
     } catch ( CepGen::Exception& e ) { e.dump(); }
+    ++i;
   }
 
   return 0;
@@ -1,6 +1,7 @@
 #include <iostream>
 
 #include "CepGen/Generator.h"
+#include "CepGen/Core/Cocktail.h"
 #include "CepGen/Cards/LpairReader.h"
 #include "CepGen/Cards/ConfigReader.h"
 #include "CepGen/Core/Logger.h"
@@ -52,19 +53,31 @@ int main( int argc, char* argv[] ) {
   // We might want to cross-check visually the validity of our run
   mg.parameters->dump();
 
-  // Let there be cross-section...
-  double xsec, err;
-  mg.computeXsection( xsec, err );
+  // Several modes to be generated together, in a single stream of events
+  std::unique_ptr<CepGen::Cocktail> cocktail;
+  if ( !mg.parameters->cocktail.empty() ) cocktail.reset( new CepGen::Cocktail( *mg.parameters ) );
+
+  // Let there be cross-section... (unless a previous run can be resumed)
+  unsigned int num_events = mg.parameters->generation.maxgen, i = 0;
+  if ( mg.parameters->generation.checkpoint_every > 0 && ifstream( mg.parameters->generation.checkpoint_file ).good() ) {
+    const std::string& file = mg.parameters->generation.checkpoint_file;
+    i = ( cocktail ) ? cocktail->resume( file ).ngen : mg.resume( file ).ngen;
+    num_events = ( i < num_events ) ? num_events-i : 0;
+  }
+  else {
+    double xsec, err;
+    if ( cocktail ) cocktail->computeXsection( xsec, err );
+    else mg.computeXsection( xsec, err );
+  }
 
   if ( mg.parameters->generation.enabled ) {
     // The events generation starts here !
-    CepGen::Event ev;
-    for ( unsigned int i=0; i<mg.parameters->generation.maxgen; i++ ) {
-      ev = *mg.generateOneEvent();
+    for ( const CepGen::Event& ev : ( cocktail ) ? cocktail->events( num_events ) : mg.events( num_events ) ) {
       if ( i%1000==0 ) {
         Information( Form( "Generating event #%d", i ) );
         ev.dump();
       }
+      ++i;
     }
   }
 
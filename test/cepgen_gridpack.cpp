@@ -0,0 +1,51 @@
+#include <iostream>
+
+#include "CepGen/Generator.h"
+#include "CepGen/Cards/LpairReader.h"
+#include "CepGen/Cards/ConfigReader.h"
+
+using namespace std;
+
+/**
+ * Two-step production for the farms: one preparation job integrates the
+ * process and prepares the generation grid, then stores everything in a
+ * gridpack; the generation jobs only load it and produce their events.
+ * \date Oct 2026
+ */
+int main( int argc, char* argv[] ) {
+  const string mode = ( argc > 1 ) ? argv[1] : "";
+  if ( !( mode == "prepare" && argc > 3 ) && !( mode == "generate" && argc > 4 ) ) {
+    InError( Form( "Usage: %s prepare <config card> <gridpack file>\n\t"
+                   "   or: %s generate <gridpack file> <seed> <num events>", argv[0], argv[0] ) );
+    return -1;
+  }
+
+  CepGen::Generator mg;
+
+  //--- preparation job
+  if ( mode == "prepare" ) {
+    const std::string file( argv[2] ), extension = file.substr( file.find_last_of( "." )+1 );
+    if ( extension == "card" ) mg.setParameters( CepGen::Cards::LpairReader( argv[2] ).parameters() );
+    else if ( extension == "cfg" ) mg.setParameters( CepGen::Cards::ConfigReader( argv[2] ).parameters() );
+    mg.parameters->generation.enabled = true;
+    mg.parameters->dump();
+    mg.gridpack().save( argv[3] );
+    return 0;
+  }
+
+  //--- generation job
+  Timer tmr;
+  mg.loadGridpack( CepGen::Gridpack::load( argv[2] ), strtoull( argv[3], nullptr, 10 ) );
+  const unsigned int num_events = atoi( argv[4] );
+  unsigned int i = 0;
+  for ( const CepGen::Event& ev : mg.events( num_events ) ) {
+    if ( i == 0 ) Information( Form( "First event produced after %.3f s", tmr.elapsed() ) );
+    if ( i%1000 == 0 ) {
+      Information( Form( "Generating event #%d", i ) );
+      ev.dump();
+    }
+    ++i;
+  }
+
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include "ReferenceRun.h"
+
+#include <iostream>
+#include <vector>
+#include <assert.h>
+
+using namespace std;
+
+void
+setup( CepGen::Generator& mg, const char* checkpoint_file )
+{
+  CepGen::setReferenceRun( *mg.parameters );
+  mg.parameters->vegas.refine_npoints = 1000;
+  mg.parameters->generation.enabled = true;
+  mg.parameters->generation.gen_print_every = 1000;
+  mg.parameters->generation.checkpoint_every = 10;
+  mg.parameters->generation.checkpoint_file = checkpoint_file;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const char* checkpoint_file = "test_checkpoint.tmp";
+  remove( checkpoint_file );
+
+  //--- first run, "preempted" after 25 events (last checkpoint after 20 events)
+  vector<double> ref_pt;
+  {
+    CepGen::Generator mg;
+    setup( mg, checkpoint_file );
+    CepGen::EventStream events = mg.events( 25, 7 );
+    unsigned short num_sync = 0;
+    events.onCheckpoint( [&num_sync]() { return 100*( ++num_sync ); } );
+    for ( const CepGen::Event& ev : events ) {
+      ref_pt.emplace_back( ev.getConstById( 6 ).momentum().pt() );
+    }
+    assert( num_sync == 2 );
+  }
+
+  //--- second run, resumed from the checkpoint
+  {
+    CepGen::Generator mg;
+    setup( mg, checkpoint_file );
+    const CepGen::Checkpoint ckpt = mg.resume( checkpoint_file );
+    assert( ckpt.ngen == 20 );
+    assert( ckpt.output_position == 200 );
+    assert( ckpt.vegas.refined_bin >= 0 );
+    unsigned int i = ckpt.ngen;
+    for ( const CepGen::Event& ev : mg.events( 5 ) ) {
+      assert( ev.getConstById( 6 ).momentum().pt() == ref_pt[i] );
+      ++i;
+    }
+    assert( i == ref_pt.size() );
+  }
+  remove( checkpoint_file );
+
+  cout << "Test 1 passed!" << endl;
+
+  return 0;
+}
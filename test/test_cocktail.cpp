@@ -0,0 +1,91 @@
+#include "CepGen/Generator.h"
+#include "CepGen/Core/Cocktail.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <assert.h>
+
+using namespace std;
+
+int
+main( int argc, char* argv[] )
+{
+  CepGen::Parameters params;
+  params.setProcess( new CepGen::Process::GamGamLL );
+  params.kinematics.in1p = params.kinematics.in2p = 6500.;
+  params.kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+  params.kinematics.pt_min = 15.;
+  params.kinematics.eta_min = -2.5;
+  params.kinematics.eta_max = 2.5;
+  params.kinematics.mx_min = 1.07;
+  params.kinematics.mx_max = 320.;
+  params.vegas.ncvg = 5e4;
+  params.vegas.itvg = 2;
+  params.generation.enabled = true;
+  params.cocktail.emplace_back( CepGen::Kinematics::ElasticElastic, CepGen::SuriYennie, CepGen::Particle::Muon );
+  params.cocktail.emplace_back( CepGen::Kinematics::InelasticElastic, CepGen::SuriYennie, CepGen::Particle::Muon );
+
+  CepGen::Cocktail cocktail( params );
+  assert( cocktail.numChannels() == 2 );
+  //--- all channels share the seed of the run, but not its random streams
+  assert( cocktail.channel( 0 ).parameters->vegas.seed == params.vegas.seed );
+  assert( cocktail.channel( 0 ).parameters->vegas.stream != params.vegas.stream );
+  assert( cocktail.channel( 0 ).parameters->vegas.stream != cocktail.channel( 1 ).parameters->vegas.stream );
+  double xsec, err;
+  cocktail.computeXsection( xsec, err );
+  assert( fabs( xsec-cocktail.channel( 0 ).crossSection()-cocktail.channel( 1 ).crossSection() ) < 1.e-10*xsec );
+
+  cout << "Test 1 passed!" << endl;
+
+  //--- channels picked according to their cross section
+  const unsigned int num_events = 2000;
+  vector<unsigned int> num_per_channel( 2, 0 );
+  for ( unsigned int i=0; i<num_events; i++ ) {
+    const CepGen::Event* ev = cocktail.generateOneEvent();
+    const unsigned short chan = cocktail.lastChannel();
+    num_per_channel[chan]++;
+    //--- the first outgoing proton is only dissociated in the single-dissociative channel
+    const CepGen::Particle& op1 = const_cast<CepGen::Event*>( ev )->getOneByRole( CepGen::Particle::OutgoingBeam1 );
+    assert( ( op1.pdgId() == CepGen::Particle::Proton ) == ( chan == 0 ) );
+  }
+  const double frac = cocktail.channel( 1 ).crossSection()/xsec,
+               expected = frac*num_events, sigma = sqrt( num_events*frac*( 1.-frac ) );
+  assert( fabs( num_per_channel[1]-expected ) < 5.*sigma );
+
+  cout << "Test 2 passed!" << endl;
+
+  //--- single stream of events mixing all channels, resumed from its last checkpoint
+  const char* checkpoint_file = "test_cocktail.tmp";
+  remove( checkpoint_file );
+  params.generation.checkpoint_every = 10;
+  params.generation.checkpoint_file = checkpoint_file;
+  vector<double> ref_pt;
+  {
+    CepGen::Cocktail ckt( params );
+    unsigned int num_dissociated = 0;
+    for ( const CepGen::Event& ev : ckt.events( 25, 7 ) ) {
+      ref_pt.emplace_back( ev.getConstById( 6 ).momentum().pt() );
+      if ( const_cast<CepGen::Event&>( ev ).getOneByRole( CepGen::Particle::OutgoingBeam1 ).pdgId() != CepGen::Particle::Proton ) num_dissociated++;
+    }
+    assert( ref_pt.size() == 25 && ckt.numGenerated() == 25 );
+    assert( num_dissociated > 0 && num_dissociated < 25 );
+  }
+  {
+    CepGen::Cocktail ckt( params );
+    const CepGen::Checkpoint ckpt = ckt.resume( checkpoint_file );
+    assert( ckpt.ngen == 20 && ckpt.channels.size() == 2 );
+    unsigned int i = ckpt.ngen;
+    for ( const CepGen::Event& ev : ckt.events( 5 ) ) {
+      assert( ev.getConstById( 6 ).momentum().pt() == ref_pt[i] );
+      ++i;
+    }
+    assert( i == ref_pt.size() );
+  }
+  remove( checkpoint_file );
+
+  cout << "Test 3 passed!" << endl;
+
+  return 0;
+}
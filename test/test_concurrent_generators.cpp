@@ -0,0 +1,88 @@
+#include "CepGen/Generator.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <assert.h>
+
+using namespace std;
+
+/// Results of one independent run
+struct Run
+{
+  double xsec, err;
+  vector<double> pt;
+};
+
+/// Integrate and generate a few events for one configuration
+void
+run( unsigned short i, Run& out )
+{
+  //--- each thread has its own logging threshold
+  CepGen::Logger::get().level = ( i%2 == 0 ) ? CepGen::Logger::Nothing : CepGen::Logger::Error;
+
+  CepGen::Parameters* params = new CepGen::Parameters;
+  params->setProcess( new CepGen::Process::GamGamLL );
+  params->kinematics.mode = ( i%2 == 0 ) ? CepGen::Kinematics::ElasticElastic : CepGen::Kinematics::InelasticElastic;
+  params->kinematics.in1p = params->kinematics.in2p = 6500.;
+  params->kinematics.pair = CepGen::Particle::Muon;
+  params->kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+  params->kinematics.pt_min = 10.+5.*i;
+  params->kinematics.eta_min = -2.5;
+  params->kinematics.eta_max = 2.5;
+  params->kinematics.mx_max = 320.;
+  params->vegas.ncvg = 1e4;
+  params->vegas.itvg = 2;
+  params->vegas.npoints = 10;
+  params->vegas.seed = 42+i;
+  params->generation.enabled = true;
+  params->generation.gen_print_every = 1000;
+
+  CepGen::Generator mg( params );
+  mg.computeXsection( out.xsec, out.err );
+  for ( unsigned short j=0; j<10; j++ ) {
+    out.pt.emplace_back( mg.generateOneEvent()->getConstById( 6 ).momentum().pt() );
+  }
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const unsigned short num_runs = 4;
+
+  //--- all runs performed one after the other...
+  vector<Run> sequential( num_runs );
+  for ( unsigned short i=0; i<num_runs; i++ ) run( i, sequential[i] );
+
+  //--- ...or all at the same time
+  vector<Run> concurrent( num_runs );
+  vector<thread> threads;
+  for ( unsigned short i=0; i<num_runs; i++ ) threads.emplace_back( run, i, std::ref( concurrent[i] ) );
+  for ( auto& thr : threads ) thr.join();
+
+  for ( unsigned short i=0; i<num_runs; i++ ) {
+    assert( concurrent[i].xsec == sequential[i].xsec );
+    assert( concurrent[i].err == sequential[i].err );
+    assert( concurrent[i].pt == sequential[i].pt );
+  }
+
+  cout << "Test 1 passed!" << endl;
+
+  //--- new threads log as the main one, unless told otherwise
+  CepGen::Logger::get().level = CepGen::Logger::Information;
+  assert( &CepGen::Logger::get() == &CepGen::Logger::main() );
+  CepGen::Logger parent( CepGen::Logger::Debug );
+  thread( [&parent]() {
+    assert( CepGen::Logger::get().level == CepGen::Logger::Information );
+    CepGen::Logger::get().level = CepGen::Logger::Nothing;
+    assert( CepGen::Logger::main().level == CepGen::Logger::Information );
+    CepGen::Logger::inherit( parent );
+    assert( CepGen::Logger::get().level == CepGen::Logger::Debug );
+  } ).join();
+  assert( CepGen::Logger::get().level == CepGen::Logger::Information );
+
+  cout << "Test 2 passed!" << endl;
+
+  return 0;
+}
@@ -1,33 +1,41 @@
 #include "CepGen/Generator.h"
+#include "CepGen/Core/CrossSectionScan.h"
+#include "CepGen/Cards/ConfigReader.h"
 #include "CepGen/Processes/GamGamLL.h"
 
 using namespace std;
 
 int main( int argc, char* argv[] )
 {
-  if ( argc<5 ) {
-    InError( Form( "Usage: %s <process mode=1..4> <num points> <min value> <max value> [output file=xsect.dat]", argv[0] ) );
+  if ( argc<2 || ( argc<5 && string( argv[1] ).find( ".cfg" ) == string::npos ) ) {
+    InError( Form( "Usage: %s <process mode=1..4> <num points> <min value> <max value> [output file=xsect.dat] [parameter=pt_min] [num threads=all] [warm start=1] [target precision=none]\n\t"
+                   "   or: %s <config card with a scan block> [output file=xsect.dat]", argv[0], argv[0] ) );
     return -1;
   }
-  const unsigned int proc_mode = atoi( argv[1] ),
-                     npoints = atoi( argv[2] );
-  const float min_value = atof( argv[3] ),
-              max_value = atof( argv[4] );
-  const char* output_file = ( argc>5 ) ? argv[5] : "xsect.dat";
-
-  CepGen::Generator mg;
 
   CepGen::Logger::get().level = CepGen::Logger::Error;
 
-  CepGen::Parameters* par = mg.parameters.get();
-  par->kinematics.eta_min = -2.5; par->kinematics.eta_max = 2.5;
-  par->kinematics.in1p = par->kinematics.in2p = 6.5e3;
-  par->kinematics.mx_max = 1000.0;
-  par->setProcess( new CepGen::Process::GamGamLL );
-  par->process_mode = static_cast<CepGen::Kinematics::ProcessMode>( proc_mode );
-  par->dump();
-
-  double xsect, err_xsect;
+  CepGen::Generator mg;
+  const char* output_file = "xsect.dat";
+  if ( argc<5 ) {
+    mg.setParameters( CepGen::Cards::ConfigReader( argv[1] ).parameters() );
+    if ( argc>2 ) output_file = argv[2];
+  }
+  CepGen::Parameters& par = *mg.parameters;
+  if ( argc>=5 ) {
+    par.kinematics.eta_min = -2.5; par.kinematics.eta_max = 2.5;
+    par.kinematics.in1p = par.kinematics.in2p = 6.5e3;
+    par.kinematics.mx_max = 1000.0;
+    par.setProcess( new CepGen::Process::GamGamLL );
+    par.kinematics.mode = static_cast<CepGen::Kinematics::ProcessMode>( atoi( argv[1] ) );
+    par.scan.setRange( atof( argv[3] ), atof( argv[4] ), atoi( argv[2] ) );
+    if ( argc>5 ) output_file = argv[5];
+    par.scan.parameter = ( argc>6 ) ? argv[6] : "pt_min";
+    if ( argc>7 ) par.scan.num_threads = atoi( argv[7] );
+    if ( argc>8 ) par.scan.warm_start = atoi( argv[8] );
+    if ( argc>9 ) par.vegas.precision = atof( argv[9] );
+  }
+  par.dump();
 
   ofstream xsect_file( output_file );
   if ( !xsect_file.is_open() ) {
@@ -35,12 +43,9 @@ int main( int argc, char* argv[] )
     return -2;
   }
 
-  for ( unsigned int i=0; i<npoints; i++ ) {
-    par->kinematics.pt_min = min_value + (max_value-min_value)*i/npoints;
-    mg.computeXsection( xsect, err_xsect );
-    xsect_file << Form( "%.2f\t%.5f\t%.5f\n", par->kinematics.pt_min, xsect, err_xsect );
-    xsect_file.flush();
-  }
+  CepGen::CrossSectionScan scan( par );
+  scan.run();
+  scan.write( xsect_file );
 
   return 0;
 }
@@ -0,0 +1,72 @@
+#include "ReferenceRun.h"
+
+#include <iostream>
+#include <vector>
+#include <assert.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+void
+setup( CepGen::Generator& mg )
+{
+  CepGen::setReferenceRun( *mg.parameters );
+  mg.parameters->generation.enabled = true;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const char* gridpack_file = "test_gridpack.tmp";
+  const unsigned int num_events = 20;
+
+  //--- preparation run
+  vector<double> ref_pt;
+  double ref_xsec;
+  {
+    CepGen::Generator mg;
+    setup( mg );
+    mg.gridpack().save( gridpack_file );
+    ref_xsec = mg.crossSection();
+    ref_pt = CepGen::generateLeptonPt( mg, num_events );
+  }
+
+  //--- generation job with the seed of the preparation run
+  {
+    CepGen::Generator mg;
+    setup( mg );
+    mg.loadGridpack( CepGen::Gridpack::load( gridpack_file ), 42 );
+    assert( mg.crossSection() == ref_xsec );
+    assert( CepGen::generateLeptonPt( mg, num_events ) == ref_pt );
+  }
+
+  cout << "Test 1 passed!" << endl;
+
+  //--- generation job with its own seed
+  {
+    CepGen::Generator mg;
+    setup( mg );
+    mg.loadGridpack( CepGen::Gridpack::load( gridpack_file ), 1234 );
+    assert( mg.numFunctionCalls() == 0 );
+    assert( mg.parameters->vegas.seed == 1234 );
+    assert( CepGen::generateLeptonPt( mg, num_events ) != ref_pt );
+  }
+  remove( gridpack_file );
+
+  cout << "Test 2 passed!" << endl;
+
+  //--- a failed writing (here, over a directory) leaves no temporary file behind
+  const char* dir = "test_gridpack_dir.tmp";
+  mkdir( dir, 0755 );
+  assert( !writeAtomically( dir, []( std::ostream& os ) { os << "gridpack"; } ) );
+  glob_t leftovers;
+  assert( glob( "test_gridpack_dir.tmp.*", 0, nullptr, &leftovers ) == GLOB_NOMATCH );
+  globfree( &leftovers );
+  rmdir( dir );
+
+  cout << "Test 3 passed!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include "ReferenceRun.h"
+
+#include <iostream>
+#include <cmath>
+#include <assert.h>
+
+using namespace std;
+
+void
+setup( CepGen::Generator& mg )
+{
+  CepGen::setReferenceRun( *mg.parameters );
+  mg.parameters->vegas.itvg = 3;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  //--- reference run, without histograms
+  double ref_xsec, ref_err;
+  {
+    CepGen::Generator mg;
+    setup( mg );
+    mg.computeXsection( ref_xsec, ref_err );
+  }
+
+  //--- same run, with the histograms filled along the integration
+  CepGen::Generator mg;
+  setup( mg );
+  mg.parameters->histograms.emplace_back( "m_central", 50, 0., 1000. );
+  mg.parameters->histograms.emplace_back( "pt_single", 20, 0., 1000. );
+  mg.parameters->histograms.emplace_back( "eta_single", 10, -2.5, 2.5 );
+  mg.parameters->histograms.emplace_back( "pt_single", 6, 0., 30. );
+  double xsec, err;
+  mg.computeXsection( xsec, err );
+  assert( xsec == ref_xsec && err == ref_err );
+
+  cout << "Test 1 passed!" << endl;
+
+  //--- histograms covering the whole phase space are compatible with the cross section
+  //    (each central particle contributes to the single particle distributions)
+  const vector<CepGen::Histogram>& hists = mg.histograms();
+  assert( hists.size() == 4 );
+  assert( fabs( hists[0].integral()-xsec ) < 3.*err );
+  assert( fabs( hists[1].integral()-2.*xsec ) < 6.*err );
+  assert( fabs( hists[2].integral()-hists[1].integral() ) < 1.e-4*xsec );
+
+  cout << "Test 2 passed!" << endl;
+
+  //--- errors on the bins contents
+  for ( const auto& hist : hists ) {
+    double err2 = 0.;
+    for ( unsigned int i=0; i<hist.numBins(); i++ ) {
+      assert( hist.error( i ) >= 0. );
+      if ( hist.value( i ) > 0. ) assert( hist.error( i ) > 0. );
+      err2 += hist.error( i )*hist.error( i );
+    }
+    assert( err2 > 0. );
+  }
+  //--- no muon below the single particle pT threshold
+  for ( unsigned int i=0; i<hists[3].numBins(); i++ ) {
+    if ( hists[3].binHigh( i ) <= 15. ) assert( hists[3].value( i ) == 0. );
+    else assert( hists[3].value( i ) > 0. );
+  }
+
+  cout << "Test 3 passed!" << endl;
+
+  return 0;
+}
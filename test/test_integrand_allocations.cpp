@@ -0,0 +1,84 @@
+#include "CepGen/Generator.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <assert.h>
+
+using namespace std;
+
+//--- count all allocations performed in this program
+
+static atomic<unsigned long long> num_allocations( 0 );
+
+void* operator new( size_t size )
+{
+  num_allocations++;
+  if ( void* ptr = malloc( size ) ) return ptr;
+  throw bad_alloc();
+}
+void operator delete( void* ptr ) noexcept { free( ptr ); }
+void operator delete( void* ptr, size_t ) noexcept { free( ptr ); }
+
+unsigned long long
+countAllocations( CepGen::Generator& mg, vector<double>& x, CepGen::RandomGenerator& rng, unsigned int num_evaluations, bool store, unsigned int& num_non_zero )
+{
+  unique_ptr<CepGen::IntegrandContext> ctx = mg.replicaContext();
+  ctx->storage = store;
+  const size_t ndim = mg.numDimensions();
+  //--- warm-up (first evaluations may reserve some memory)
+  for ( unsigned int i=0; i<1000; i++ ) {
+    rng.fill( &x[0], ndim );
+    CepGen::f( &x[0], ndim, ctx.get() );
+  }
+  num_non_zero = 0;
+  const unsigned long long before = num_allocations;
+  for ( unsigned int i=0; i<num_evaluations; i++ ) {
+    rng.fill( &x[0], ndim );
+    if ( CepGen::f( &x[0], ndim, ctx.get() ) > 0. ) num_non_zero++;
+  }
+  return num_allocations-before;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const CepGen::Kinematics::ProcessMode modes[] = {
+    CepGen::Kinematics::ElasticElastic, CepGen::Kinematics::InelasticElastic,
+    CepGen::Kinematics::ElasticInelastic, CepGen::Kinematics::InelasticInelastic
+  };
+  CepGen::RandomGenerator rng( 1 );
+  unsigned short num_test = 0;
+  for ( const auto& mode : modes ) {
+    CepGen::Generator mg;
+    mg.parameters->setProcess( new CepGen::Process::GamGamLL );
+    mg.parameters->kinematics.mode = mode;
+    mg.parameters->kinematics.in1p = mg.parameters->kinematics.in2p = 6500.;
+    mg.parameters->kinematics.pair = CepGen::Particle::Muon;
+    mg.parameters->kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+    mg.parameters->kinematics.pt_min = 15.;
+    mg.parameters->kinematics.mx_min = 1.07;
+    mg.parameters->kinematics.mx_max = 320.;
+
+    vector<double> x( mg.numDimensions(), 0.5 );
+    mg.computePoint( &x[0] ); // prepare the function
+
+    //--- integration (weights only), and events generation (full kinematics)
+    unsigned int num_non_zero = 0;
+    const unsigned long long num_integr = countAllocations( mg, x, rng, 10000, false, num_non_zero );
+    assert( num_non_zero > 0 );
+    const unsigned long long num_gen = countAllocations( mg, x, rng, 10000, true, num_non_zero );
+    assert( num_non_zero > 0 ); // the full event kinematics was computed at least once
+    cout << "Mode " << mode << ": " << num_integr << " allocation(s) while integrating, "
+         << num_gen << " while generating" << endl;
+    assert( num_integr == 0 );
+    assert( num_gen == 0 );
+
+    cout << "Test " << ++num_test << " passed!" << endl;
+  }
+
+  return 0;
+}
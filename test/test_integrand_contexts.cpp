@@ -0,0 +1,77 @@
+#include "CepGen/Generator.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <fstream>
+#include <cstdio>
+#include <assert.h>
+
+using namespace std;
+
+int
+main( int argc, char* argv[] )
+{
+  CepGen::Generator mg;
+  mg.parameters->setProcess( new CepGen::Process::GamGamLL );
+  mg.parameters->kinematics.mode = CepGen::Kinematics::ElasticElastic;
+  mg.parameters->kinematics.in1p = mg.parameters->kinematics.in2p = 6500.;
+  mg.parameters->kinematics.pair = CepGen::Particle::Muon;
+  mg.parameters->kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+  mg.parameters->kinematics.pt_min = 15.;
+  mg.parameters->vegas.ncvg = 1e4;
+  mg.parameters->vegas.itvg = 1;
+
+  double xsec, err;
+  mg.computeXsection( xsec, err );
+
+  //--- list of points, and their weights computed sequentially
+  const size_t ndim = mg.numDimensions(), num_points = 20000;
+  const unsigned short num_threads = 4;
+  CepGen::RandomGenerator rng( 1 );
+  vector<double> points( ndim*num_points ), ref( num_points );
+  rng.fill( &points[0], points.size() );
+  {
+    unique_ptr<CepGen::IntegrandContext> ctx = mg.replicaContext();
+    for ( size_t i=0; i<num_points; i++ ) ref[i] = CepGen::f( &points[i*ndim], ndim, ctx.get() );
+  }
+
+  //--- same points, shared between several threads with their own contexts
+  vector<double> weights( num_points, -1. );
+  vector<unique_ptr<CepGen::IntegrandContext> > contexts;
+  vector<thread> threads;
+  for ( unsigned short j=0; j<num_threads; j++ ) contexts.emplace_back( mg.replicaContext() );
+  for ( unsigned short j=0; j<num_threads; j++ ) {
+    threads.emplace_back( [&, j]() {
+      for ( size_t i=j; i<num_points; i+=num_threads ) weights[i] = CepGen::f( &points[i*ndim], ndim, contexts[j].get() );
+    } );
+  }
+  for ( auto& th : threads ) th.join();
+
+  unsigned int num_non_zero = 0;
+  for ( size_t i=0; i<num_points; i++ ) {
+    assert( weights[i] == ref[i] );
+    if ( ref[i] > 0. ) num_non_zero++;
+  }
+  assert( num_non_zero > 0 );
+
+  cout << "Test 1 passed!" << endl;
+
+  //--- bulk evaluation, from memory and from a file
+  const vector<double> bulk = mg.computePoints( &points[0], num_points, num_threads );
+  assert( bulk == ref );
+
+  const char* points_file = "test_integrand_contexts.tmp";
+  {
+    ofstream out( points_file, ios::binary );
+    out.write( reinterpret_cast<const char*>( &points[0] ), points.size()*sizeof( double ) );
+  }
+  const vector<double> from_file = mg.computePoints( points_file );
+  remove( points_file );
+  assert( from_file == ref );
+
+  cout << "Test 2 passed!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include "CepGen/Generator.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <assert.h>
+
+using namespace std;
+
+/**
+ * Time needed to compute one point of the phase space (median of a few passes on the same points)
+ * \param[in] recompute Recompute the quantities fixed for the whole run at each point, as before they were cached
+ *  (the beams are also looked up in the event record for each point, thus the gain is somewhat overestimated)
+ * \param[out] sum Sum of the weights of all points
+ */
+double
+timePerPoint( CepGen::Generator& mg, const vector<double>& points, unsigned int num_passes, bool recompute, unsigned int& num_non_zero, double& sum )
+{
+  const size_t ndim = mg.numDimensions(), num_points = points.size()/ndim;
+  CepGen::Process::GenericProcess* proc = mg.parameters->process();
+  vector<double> x( points );
+  vector<double> times;
+  for ( unsigned int i=0; i<num_passes; i++ ) {
+    num_non_zero = 0;
+    sum = 0.;
+    Timer tmr;
+    for ( size_t j=0; j<num_points; j++ ) {
+      if ( recompute ) proc->prepareKinematics();
+      const double weight = mg.computePoint( &x[j*ndim] );
+      if ( weight > 0. ) num_non_zero++;
+      sum += weight;
+    }
+    times.emplace_back( tmr.elapsed()/num_points );
+  }
+  sort( times.begin(), times.end() );
+  return times[times.size()/2];
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const unsigned int num_points = ( argc > 1 ) ? atoi( argv[1] ) : 50000, num_passes = 5;
+
+  const CepGen::Kinematics::ProcessMode modes[] = {
+    CepGen::Kinematics::ElasticElastic, CepGen::Kinematics::InelasticElastic, CepGen::Kinematics::InelasticInelastic
+  };
+  for ( const auto& mode : modes ) {
+    CepGen::Generator mg;
+    mg.parameters->setProcess( new CepGen::Process::GamGamLL );
+    mg.parameters->kinematics.mode = mode;
+    mg.parameters->kinematics.in1p = mg.parameters->kinematics.in2p = 6500.;
+    mg.parameters->kinematics.pair = CepGen::Particle::Muon;
+    mg.parameters->kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+    mg.parameters->kinematics.pt_min = 15.;
+    mg.parameters->kinematics.eta_min = -2.5;
+    mg.parameters->kinematics.eta_max = 2.5;
+    mg.parameters->kinematics.mx_max = 1000.;
+
+    CepGen::RandomGenerator rng( 3 );
+    vector<double> points( mg.numDimensions()*num_points );
+    rng.fill( &points[0], points.size() );
+    mg.computePoint( &points[0] ); // prepare the function
+
+    //--- run invariants computed once (default), or recomputed for each point
+    unsigned int num_non_zero = 0, num_non_zero_recomputed = 0;
+    double sum = 0., sum_recomputed = 0.;
+    const double time = timePerPoint( mg, points, num_passes, false, num_non_zero, sum ),
+                 time_recomputed = timePerPoint( mg, points, num_passes, true, num_non_zero_recomputed, sum_recomputed );
+    assert( num_non_zero > 0 );
+    assert( num_non_zero == num_non_zero_recomputed && sum == sum_recomputed );
+    ostringstream os; os << mode;
+    cout << Form( "%-25s %6d/%d non-zero weights, time per point: %.3f us (%.3f us with the invariants recomputed for each point, %.1f%% gain)",
+                  os.str().c_str(), num_non_zero, num_points, time*1.e6, time_recomputed*1.e6, ( 1.-time/time_recomputed )*100. ) << endl;
+  }
+
+  cout << "Test passed!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include "CepGen/Core/IntegrationCache.h"
+
+#include "ReferenceRun.h"
+
+#include <iostream>
+#include <vector>
+#include <assert.h>
+#include <unistd.h>
+
+using namespace std;
+
+void
+setup( CepGen::Generator& mg, const char* cache_dir )
+{
+  CepGen::setReferenceRun( *mg.parameters );
+  mg.parameters->vegas.cache_directory = cache_dir;
+  mg.parameters->generation.enabled = true;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const char* cache_dir = "test_integration_cache.tmp";
+  const unsigned int num_events = 20;
+
+  //--- first run, filling the cache
+  vector<double> ref_pt;
+  double ref_xsec, ref_err;
+  string entry;
+  {
+    CepGen::Generator mg;
+    setup( mg, cache_dir );
+    entry = CepGen::IntegrationCache( cache_dir ).file( *mg.parameters );
+    remove( entry.c_str() );
+    mg.computeXsection( ref_xsec, ref_err );
+    ref_pt = CepGen::generateLeptonPt( mg, num_events );
+  }
+  assert( access( entry.c_str(), F_OK ) == 0 );
+
+  cout << "Test 1 passed!" << endl;
+
+  //--- second run, integration and generation grid retrieved from the cache
+  {
+    CepGen::Generator mg;
+    setup( mg, cache_dir );
+    double xsec, err;
+    mg.computeXsection( xsec, err );
+    assert( mg.numFunctionCalls() == 0 );
+    assert( xsec == ref_xsec && err == ref_err );
+    assert( CepGen::generateLeptonPt( mg, num_events ) == ref_pt );
+  }
+
+  cout << "Test 2 passed!" << endl;
+
+  //--- any change in the integrand definition leads to another entry
+  {
+    CepGen::Generator mg;
+    setup( mg, cache_dir );
+    const string descr = CepGen::IntegrationCache::description( *mg.parameters );
+    mg.parameters->kinematics.pt_min = 15.+1.e-12;
+    assert( CepGen::IntegrationCache::description( *mg.parameters ) != descr );
+    assert( CepGen::IntegrationCache( cache_dir ).file( *mg.parameters ) != entry );
+    mg.parameters->kinematics.pt_min = 15.;
+    mg.parameters->taming_functions.add( "q2", "exp(-q2)" );
+    assert( CepGen::IntegrationCache( cache_dir ).file( *mg.parameters ) != entry );
+  }
+  remove( entry.c_str() );
+  rmdir( cache_dir );
+
+  cout << "Test 3 passed!" << endl;
+
+  return 0;
+}
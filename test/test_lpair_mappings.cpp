@@ -0,0 +1,52 @@
+#include "CepGen/Generator.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+#include <assert.h>
+
+void
+computeXsection( CepGen::Kinematics::ProcessMode mode, int nopt, double& xsec, double& err_xsec )
+{
+  CepGen::Generator mg;
+  mg.parameters->setProcess( new CepGen::Process::GamGamLL( nopt ) );
+  mg.parameters->kinematics.mode = mode;
+  mg.parameters->kinematics.setSqrtS( 13.e3 );
+  mg.parameters->kinematics.pair = CepGen::Particle::Muon;
+  mg.parameters->kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+  mg.parameters->kinematics.pt_min = 15.;
+  mg.parameters->kinematics.eta_min = -2.5;
+  mg.parameters->kinematics.eta_max = 2.5;
+  mg.parameters->kinematics.mx_max = 1000.;
+  mg.parameters->vegas.ncvg = 50000;
+  mg.parameters->vegas.itvg = 5;
+  mg.computeXsection( xsec, err_xsec );
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const double num_sigma = 5.0;
+
+  //--- only the non-default mappings alter the integrand definition
+  assert( CepGen::Process::GamGamLL().settings().empty() );
+  assert( CepGen::Process::GamGamLL( -1 ).settings() != CepGen::Process::GamGamLL( 1 ).settings() );
+
+  for ( const auto& mode : { CepGen::Kinematics::ElasticElastic, CepGen::Kinematics::InelasticElastic, CepGen::Kinematics::InelasticInelastic } ) {
+    //--- reference: default mappings
+    double xsec_ref, err_xsec_ref;
+    computeXsection( mode, 0, xsec_ref, err_xsec_ref );
+
+    for ( const auto& nopt : { -1, -2, 1, 2 } ) {
+      double xsec, err_xsec;
+      computeXsection( mode, nopt, xsec, err_xsec );
+
+      const double sigma = fabs( xsec-xsec_ref ) / sqrt( err_xsec*err_xsec + err_xsec_ref*err_xsec_ref );
+      Information( Form( "Mode %d, nopt = %d:\n\tRef.      = %.3e +/- %.3e\n\tOptimised = %.3e +/- %.3e\n\tPull: %.3f",
+                         mode, nopt, xsec_ref, err_xsec_ref, xsec, err_xsec, sigma ) );
+      assert( sigma < num_sigma );
+    }
+  }
+
+  Information( "ALL TESTS PASSED!" );
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "CepGen/Generator.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <assert.h>
+
+using namespace std;
+
+/// Parse a metrics file into a map of samples (with their labels) and values
+map<string,double>
+readMetrics( const char* file, unsigned short& num_types )
+{
+  map<string,double> out;
+  ifstream in( file );
+  string line;
+  num_types = 0;
+  while ( getline( in, line ) ) {
+    if ( line.find( "# TYPE cepgen_queue_depth " ) == 0 ) num_types++;
+    if ( line.empty() || line[0] == '#' ) continue;
+    const size_t pos = line.rfind( ' ' );
+    out[line.substr( 0, pos )] = stod( line.substr( pos+1 ) );
+  }
+  return out;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const char* metrics_file = "test_metrics.tmp";
+  const unsigned int num_events = 500;
+
+  CepGen::Generator mg;
+  mg.parameters->setProcess( new CepGen::Process::GamGamLL );
+  mg.parameters->kinematics.mode = CepGen::Kinematics::ElasticElastic;
+  mg.parameters->kinematics.in1p = mg.parameters->kinematics.in2p = 6500.;
+  mg.parameters->kinematics.pair = CepGen::Particle::Muon;
+  mg.parameters->kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+  mg.parameters->kinematics.pt_min = 15.;
+  mg.parameters->kinematics.eta_min = -2.5;
+  mg.parameters->kinematics.eta_max = 2.5;
+  mg.parameters->vegas.ncvg = 5e4;
+  mg.parameters->vegas.itvg = 2;
+  mg.parameters->generation.enabled = true;
+  mg.parameters->generation.gen_print_every = 1000;
+  mg.parameters->generation.metrics_file = metrics_file;
+  mg.parameters->generation.metrics_period = 0.01;
+
+  unsigned short num_types = 0;
+  {
+    CepGen::EventStream events = mg.events( num_events );
+    long long output_size = 0;
+    events.onBatch( [&output_size]() { return output_size; } );
+    unsigned int i = 0;
+    for ( const CepGen::Event& ev : events ) {
+      output_size += ev.numParticles();
+      //--- the metrics are exported while the events are consumed
+      if ( ++i == num_events/2 ) {
+        this_thread::sleep_for( chrono::milliseconds( 100 ) );
+        const map<string,double> metrics = readMetrics( metrics_file, num_types );
+        assert( metrics.at( "cepgen_events_requested" ) == num_events );
+        assert( metrics.at( "cepgen_events_generated" ) > 0 && metrics.at( "cepgen_events_generated" ) < num_events );
+        assert( metrics.count( "cepgen_eta_seconds" ) == 1 );
+      }
+    }
+  }
+  cout << "Test 1 passed!" << endl;
+
+  //--- last snapshot, written when the stream is released
+  const map<string,double> metrics = readMetrics( metrics_file, num_types );
+  assert( num_types == 1 );
+  assert( metrics.at( "cepgen_events_generated" ) == num_events );
+  assert( metrics.at( "cepgen_points_sampled" ) == num_events );
+  assert( metrics.at( "cepgen_trials_total" ) >= num_events );
+  assert( metrics.at( "cepgen_acceptance_rate" ) > 0. && metrics.at( "cepgen_acceptance_rate" ) <= 1. );
+  assert( metrics.at( "cepgen_integrand_calls_total" ) == metrics.at( "cepgen_trials_total" )+num_events );
+  assert( metrics.at( "cepgen_output_bytes" ) == 9*num_events );
+  assert( metrics.at( "cepgen_eta_seconds" ) == 0. );
+  assert( metrics.count( "cepgen_queue_depth{queue=\"points\"}" ) == 1 );
+  assert( metrics.count( "cepgen_queue_depth{queue=\"events\"}" ) == 1 );
+  remove( metrics_file );
+
+  cout << "Test 2 passed!" << endl;
+
+  return 0;
+}
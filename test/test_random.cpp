@@ -0,0 +1,48 @@
+#include "CepGen/Core/RandomGenerator.h"
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <assert.h>
+
+using namespace std;
+
+int
+main( int argc, char* argv[] )
+{
+  //--- known-answer test for Philox4x32-10 (counter and key set to zero)
+  CepGen::RandomGenerator rng;
+  const uint32_t ref[4] = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+  for ( unsigned short i=0; i<4; i++ ) assert( rng.integer() == ref[i] );
+
+  cout << "Test 1 passed!" << endl;
+
+  //--- reproducibility, bulk filling, and random access
+  const size_t num = 1001;
+  CepGen::RandomGenerator rng1( 42, 3 ), rng2( 42, 3 ), rng3( 42, 4 );
+  vector<double> draws( num ), bulk( num );
+  double sum = 0.;
+  for ( size_t i=0; i<num; i++ ) {
+    draws[i] = rng1.uniform();
+    assert( draws[i] > 0. && draws[i] < 1. );
+    sum += draws[i];
+  }
+  assert( fabs( sum/num-0.5 ) < 0.05 );
+  rng2.uniform(); // start from an unaligned position
+  bulk[0] = draws[0];
+  rng2.fill( &bulk[1], num-1 );
+  assert( bulk == draws );
+  assert( rng2.position() == num );
+
+  rng2.seek( 13 );
+  assert( rng2.uniform() == draws[13] );
+
+  //--- independent streams
+  unsigned int num_equal = 0;
+  for ( size_t i=0; i<num; i++ ) if ( rng3.uniform() == draws[i] ) num_equal++;
+  assert( num_equal == 0 );
+
+  cout << "Test 2 passed!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include "CepGen/Generator.h"
+#include "CepGen/Core/Cocktail.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <assert.h>
+
+using namespace std;
+
+/// Retrieve the raw value associated to a key in a JSON document
+string
+value( const string& json, const string& key )
+{
+  const size_t pos = json.find( "\""+key+"\": " );
+  if ( pos == string::npos ) return "";
+  const size_t beg = pos+key.size()+4, end = json.find_first_of( ",\n", beg );
+  return json.substr( beg, end-beg );
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const char* report_file = "test_run_report.tmp";
+  const unsigned int num_events = 50;
+
+  double xsec = 0.;
+  {
+    CepGen::Generator mg;
+    mg.parameters->setProcess( new CepGen::Process::GamGamLL );
+    mg.parameters->kinematics.mode = CepGen::Kinematics::ElasticElastic;
+    mg.parameters->kinematics.in1p = mg.parameters->kinematics.in2p = 6500.;
+    mg.parameters->kinematics.pair = CepGen::Particle::Muon;
+    mg.parameters->kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+    mg.parameters->kinematics.pt_min = 15.;
+    mg.parameters->kinematics.eta_min = -2.5;
+    mg.parameters->kinematics.eta_max = 2.5;
+    mg.parameters->vegas.ncvg = 5e4;
+    mg.parameters->vegas.itvg = 2;
+    mg.parameters->vegas.seed = 42;
+    mg.parameters->generation.enabled = true;
+    mg.parameters->report_file = report_file;
+    for ( unsigned int i=0; i<num_events; i++ ) mg.generateOneEvent();
+    xsec = mg.crossSection();
+
+    const CepGen::RunReport report = mg.report();
+    assert( report.num_events == num_events );
+    assert( report.vegas.num_sampled == num_events );
+    assert( report.vegas.num_iterations == 2 );
+    assert( report.vegas.integration_calls > 0 && report.vegas.grid_calls > 0 );
+    assert( report.vegas.sampling_calls >= num_events );
+    assert( report.vegas.grid_efficiency > 0. && report.vegas.grid_efficiency <= 1. );
+    assert( !report.integration_restored );
+  }
+
+  cout << "Test 1 passed!" << endl;
+
+  //--- the report is written when the generator goes out of scope
+  ifstream in( report_file );
+  assert( in.is_open() );
+  ostringstream os;
+  os << in.rdbuf();
+  const string json = os.str();
+  assert( value( json, "hash" ).size() == 18 );
+  assert( value( json, "seed" ) == "42" );
+  assert( value( json, "num_events" ) == "50" );
+  assert( value( json, "num_sampled" ) == "50" );
+  assert( fabs( stod( value( json, "cross_section" ) )/xsec-1. ) < 1.e-8 );
+  const double efficiency = stod( value( json, "efficiency" ) );
+  assert( efficiency > 0. && efficiency <= 1. );
+  assert( stol( value( json, "peak_memory_kb" ) ) > 0 );
+  assert( stod( value( json, "wall_time" ) ) > 0. );
+  remove( report_file );
+
+  cout << "Test 2 passed!" << endl;
+
+  //--- one report for the whole cocktail, aggregating all channels
+  {
+    CepGen::Parameters params;
+    params.setProcess( new CepGen::Process::GamGamLL );
+    params.kinematics.in1p = params.kinematics.in2p = 6500.;
+    params.kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+    params.kinematics.pt_min = 15.;
+    params.kinematics.eta_min = -2.5;
+    params.kinematics.eta_max = 2.5;
+    params.vegas.ncvg = 5e4;
+    params.vegas.itvg = 2;
+    params.vegas.seed = 42;
+    params.generation.enabled = true;
+    params.report_file = report_file;
+    params.cocktail.emplace_back( CepGen::Kinematics::ElasticElastic, CepGen::SuriYennie, CepGen::Particle::Muon );
+    params.cocktail.emplace_back( CepGen::Kinematics::ElasticElastic, CepGen::SuriYennie, CepGen::Particle::Electron );
+    CepGen::Cocktail cocktail( params );
+    for ( unsigned int i=0; i<cocktail.numChannels(); i++ ) assert( cocktail.channel( i ).parameters->report_file.empty() );
+    for ( unsigned int i=0; i<num_events; i++ ) cocktail.generateOneEvent();
+    xsec = cocktail.crossSection();
+
+    const CepGen::RunReport report = cocktail.report();
+    assert( report.num_events == num_events );
+    assert( report.vegas.num_sampled == cocktail.channel( 0 ).report().vegas.num_sampled+cocktail.channel( 1 ).report().vegas.num_sampled );
+    assert( report.vegas.integration_calls == cocktail.channel( 0 ).report().vegas.integration_calls+cocktail.channel( 1 ).report().vegas.integration_calls );
+    assert( report.vegas.grid_efficiency > 0. && report.vegas.grid_efficiency <= 1. );
+    assert( report.configuration_hash != cocktail.channel( 0 ).report().configuration_hash );
+  }
+  in.close(); in.open( report_file );
+  assert( in.is_open() );
+  os.str( "" );
+  os << in.rdbuf();
+  const string cocktail_json = os.str();
+  assert( value( cocktail_json, "num_events" ) == "50" );
+  assert( fabs( stod( value( cocktail_json, "cross_section" ) )/xsec-1. ) < 1.e-8 );
+  remove( report_file );
+
+  cout << "Test 3 passed!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+#include "CepGen/Core/Simd.h"
+#include "CepGen/Core/utils.h"
+
+#include <iostream>
+#include <functional>
+#include <assert.h>
+
+using namespace std;
+using CepGen::Simd::Vector;
+
+/// Largest relative difference between the vector and standard library versions of a function over a range
+double
+maxDifference( const function<Vector( const Vector& )>& vec, const function<double( double )>& ref, double min, double max, bool absolute=false )
+{
+  const unsigned short width = CepGen::Simd::width<Vector>();
+  const size_t num_points = 100000;
+  double diff = 0., in[width], out[width];
+  for ( size_t i=0; i<num_points; i+=width ) {
+    for ( unsigned short l=0; l<width; l++ ) in[l] = min+( max-min )*( i+l )/( num_points-1 );
+    CepGen::Simd::store( out, vec( CepGen::Simd::load<Vector>( in ) ) );
+    for ( unsigned short l=0; l<width; l++ ) {
+      const double val = ref( in[l] );
+      diff = std::max( diff, fabs( out[l]-val )/( ( absolute || val == 0. ) ? 1. : fabs( val ) ) );
+    }
+  }
+  return diff;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const double tolerance = 1.e-15;
+
+  //--- transcendental functions, over the ranges used in the phase space mappings
+  const double exp_diff = maxDifference( []( const Vector& x ) { return CepGen::Simd::exp( x ); }, []( double x ) { return exp( x ); }, -700., 700. ),
+               expm1_diff = std::max( maxDifference( []( const Vector& x ) { return CepGen::Simd::expm1( x ); }, []( double x ) { return expm1( x ); }, -1., 1. ),
+                                      maxDifference( []( const Vector& x ) { return CepGen::Simd::expm1( x ); }, []( double x ) { return expm1( x ); }, -1.e-6, 1.e-6 ) ),
+               log_diff = maxDifference( []( const Vector& x ) { return CepGen::Simd::log( x ); }, []( double x ) { return log( x ); }, 1.e-300, 1.e5 ),
+               log1_diff = maxDifference( []( const Vector& x ) { return CepGen::Simd::log( x ); }, []( double x ) { return log( x ); }, 0.5, 2. ),
+               cos_diff = maxDifference( []( const Vector& x ) { return CepGen::Simd::cos( x ); }, []( double x ) { return cos( x ); }, -10., 10., true ),
+               sin_diff = maxDifference( []( const Vector& x ) { Vector s, c; CepGen::Simd::sincos( x, s, c ); return s; }, []( double x ) { return sin( x ); }, -10., 10., true ),
+               atan_diff = maxDifference( []( const Vector& x ) { return CepGen::Simd::atan2( x, CepGen::Simd::broadcast<Vector>( 1. ) ); }, []( double x ) { return atan( x ); }, -100., 100. ),
+               atan2_diff = maxDifference( []( const Vector& x ) { return CepGen::Simd::atan2( CepGen::Simd::broadcast<Vector>( 0.3 ), x ); }, []( double x ) { return atan2( 0.3, x ); }, -10., 10. );
+  cout << Form( "maximal differences: exp %.2e, expm1 %.2e, log %.2e (%.2e around 1), cos %.2e, sin %.2e, atan %.2e, atan2 %.2e",
+                exp_diff, expm1_diff, log_diff, log1_diff, cos_diff, sin_diff, atan_diff, atan2_diff ) << endl;
+  assert( exp_diff < tolerance && expm1_diff < tolerance && log_diff < tolerance && log1_diff < tolerance );
+  assert( cos_diff < tolerance && sin_diff < tolerance );
+  assert( atan_diff < tolerance && atan2_diff < tolerance );
+
+  cout << "Test 1 passed!" << endl;
+
+  //--- special values
+  const double inf = numeric_limits<double>::infinity();
+  double in[] = { 0., -1., inf, 1.e3 }, out[4];
+  for ( unsigned short i=0; i<4; i+=CepGen::Simd::width<Vector>() ) CepGen::Simd::store( out+i, CepGen::Simd::log( CepGen::Simd::load<Vector>( in+i ) ) );
+  assert( out[0] == -inf && std::isnan( out[1] ) && out[2] == inf );
+  for ( unsigned short i=0; i<4; i+=CepGen::Simd::width<Vector>() ) CepGen::Simd::store( out+i, CepGen::Simd::exp( CepGen::Simd::load<Vector>( in+i ) ) );
+  assert( out[0] == 1. && fabs( out[1]*exp( 1. )-1. ) < tolerance && out[2] == inf && out[3] == inf );
+
+  cout << "Test 2 passed!" << endl;
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+#include "CepGen/Generator.h"
+#include "CepGen/Core/Cocktail.h"
+#include "CepGen/Processes/GamGamLL.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <assert.h>
+
+using namespace std;
+
+/// Number of complete regions of each name in a timeline trace, and number of regions dropped
+map<string,unsigned int>
+readTrace( const char* file, unsigned long long& num_dropped )
+{
+  map<string,unsigned int> out;
+  ifstream in( file );
+  assert( in.is_open() );
+  string line;
+  getline( in, line );
+  assert( line.find( "\"traceEvents\"" ) != string::npos );
+  while ( getline( in, line ) ) {
+    if ( line.find( "\"ph\": \"X\"" ) != string::npos ) {
+      const size_t beg = line.find( "\"name\": \"" )+9;
+      out[line.substr( beg, line.find( '"', beg )-beg )]++;
+    }
+    else if ( line.find( "thread_name" ) != string::npos ) {
+      const size_t beg = line.rfind( "\"name\": \"" )+9;
+      out["thread: "+line.substr( beg, line.find( '"', beg )-beg )]++;
+    }
+    else if ( line.find( "dropped_regions" ) != string::npos ) {
+      num_dropped = stoull( line.substr( line.find( ':', line.find( "dropped_regions" ) )+1 ) );
+    }
+  }
+  return out;
+}
+
+void
+run( const char* trace_file, unsigned int capacity, unsigned int num_events )
+{
+  CepGen::Generator mg;
+  mg.parameters->setProcess( new CepGen::Process::GamGamLL );
+  mg.parameters->kinematics.mode = CepGen::Kinematics::ElasticElastic;
+  mg.parameters->kinematics.in1p = mg.parameters->kinematics.in2p = 6500.;
+  mg.parameters->kinematics.pair = CepGen::Particle::Muon;
+  mg.parameters->kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+  mg.parameters->kinematics.pt_min = 15.;
+  mg.parameters->kinematics.eta_min = -2.5;
+  mg.parameters->kinematics.eta_max = 2.5;
+  mg.parameters->vegas.ncvg = 5e4;
+  mg.parameters->vegas.itvg = 3;
+  mg.parameters->generation.enabled = true;
+  mg.parameters->generation.gen_print_every = 1000;
+  mg.parameters->trace_file = trace_file;
+  mg.parameters->trace_capacity = capacity;
+  unsigned int i = 0;
+  for ( const CepGen::Event& ev : mg.events( num_events, 10 ) ) { ( void )ev; ++i; }
+  assert( i == num_events );
+}
+
+int
+main( int argc, char* argv[] )
+{
+  const char* trace_file = "test_trace.tmp";
+  const unsigned int num_events = 100;
+
+  //--- nothing is recorded when the tracing is disabled
+  {
+    assert( !CepGen::Tracer::enabled() );
+    TraceRegion( "untraced" );
+  }
+
+  run( trace_file, 1000000, num_events );
+  assert( !CepGen::Tracer::enabled() );
+  unsigned long long num_dropped = 1;
+  map<string,unsigned int> regions = readTrace( trace_file, num_dropped );
+  assert( num_dropped == 0 );
+  assert( regions.count( "untraced" ) == 0 );
+  assert( regions["integration iteration"] == 3 );
+  assert( regions["grid preparation"] == 1 );
+  assert( regions["grid cell"] > 0 );
+  assert( regions["event sampling"] == num_events );
+  assert( regions["generation trial"] >= num_events );
+  assert( regions["event fill"] == num_events );
+  assert( regions["points batch"] == num_events/10 && regions["events batch"] == num_events/10 );
+  assert( regions["wait for events"] > 0 );
+  assert( regions["thread: generator"] == 1 && regions["thread: sampler"] == 1 && regions["thread: materialiser"] == 1 );
+
+  cout << "Test 1 passed!" << endl;
+
+  //--- only the latest regions are kept in each thread's ring buffer
+  const unsigned int capacity = 50;
+  run( trace_file, capacity, num_events );
+  regions = readTrace( trace_file, num_dropped );
+  assert( num_dropped > 0 );
+  assert( regions["event fill"] <= capacity && regions["event fill"] > 0 );
+  unsigned int num_regions = 0, num_threads = 0;
+  for ( const auto& reg : regions ) {
+    if ( reg.first.find( "thread: " ) == 0 ) num_threads += reg.second;
+    else num_regions += reg.second;
+  }
+  assert( num_regions <= num_threads*capacity );
+  remove( trace_file );
+
+  cout << "Test 2 passed!" << endl;
+
+  //--- one timeline for the whole cocktail, written once all channels are over
+  {
+    CepGen::Parameters params;
+    params.setProcess( new CepGen::Process::GamGamLL );
+    params.kinematics.in1p = params.kinematics.in2p = 6500.;
+    params.kinematics.cuts_mode = CepGen::Kinematics::BothParticles;
+    params.kinematics.pt_min = 15.;
+    params.kinematics.eta_min = -2.5;
+    params.kinematics.eta_max = 2.5;
+    params.vegas.ncvg = 5e4;
+    params.vegas.itvg = 3;
+    params.generation.enabled = true;
+    params.trace_file = trace_file;
+    params.cocktail.emplace_back( CepGen::Kinematics::ElasticElastic, CepGen::SuriYennie, CepGen::Particle::Muon );
+    params.cocktail.emplace_back( CepGen::Kinematics::ElasticElastic, CepGen::SuriYennie, CepGen::Particle::Electron );
+    CepGen::Cocktail cocktail( params );
+    assert( CepGen::Tracer::enabled() );
+    unsigned int i = 0;
+    for ( const CepGen::Event& ev : cocktail.events( num_events, 10 ) ) { ( void )ev; ++i; }
+    assert( i == num_events );
+    //--- the channels do not close the timeline of the cocktail
+    assert( CepGen::Tracer::enabled() );
+  }
+  assert( !CepGen::Tracer::enabled() );
+  regions = readTrace( trace_file, num_dropped );
+  assert( regions["integration iteration"] == 2*3 );
+  assert( regions["event fill"] == num_events );
+  assert( regions["thread: cocktail"] == 1 && regions["thread: generator"] == 0 );
+  remove( trace_file );
+
+  cout << "Test 3 passed!" << endl;
+
+  return 0;
+}
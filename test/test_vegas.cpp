@@ -26,5 +26,19 @@ main( int argc, char* argv[] )
 
   cout << "Test 1 passed!" << endl;
 
+  //--- another computation starts from a fresh grid, whatever was integrated before
+  const unsigned long long num_calls = mg.numFunctionCalls();
+  mg.computeXsection( result, error );
+  assert( mg.numFunctionCalls() == 2*num_calls );
+  assert( fabs( exact - result ) < 2.0 * error );
+
+  //--- unless it is explicitly given a grid to start from (no warm-up)
+  mg.setIntegrationGrid( mg.integrationGrid() );
+  mg.computeXsection( result, error );
+  assert( mg.numFunctionCalls() < 3*num_calls );
+  assert( fabs( exact - result ) < 2.0 * error );
+
+  cout << "Test 2 passed!" << endl;
+
   return 0;
 }